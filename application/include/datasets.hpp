@@ -0,0 +1,39 @@
+/**
+ * The datasets of the experimental study and the names under which the preprocessing
+ * notebook writes their label files, shared by all drivers.
+ */
+
+#pragma once
+
+#include <optional>
+#include <string>
+
+#include "spatial.hpp"
+
+std::string const default_datasets_directory = "../../datasets/";
+
+struct Dataset
+{
+    std::string name;
+    std::string edgesFile; // relative to the datasets directory
+    int nodeSize;          // the maximum nodeID + 1, which may be different than the actual number of nodes
+};
+
+enum class LabelType
+{
+    independent    = 0,
+    correlated     = 1,
+    anticorrelated = 2
+};
+
+/**
+ * Looks up a dataset by its id: 4:YouTube, 5:case study, 10:LiveJournal, 11:DBLP, 12:Amazon, 13:WikiTalk, 14:CitPatent
+ */
+auto GetDataset( int id ) -> std::optional< Dataset >;
+
+auto ToString( LabelType labelType ) -> char const*;
+
+/**
+ * Returns the name of the label file of a given type and dimensionality, relative to the datasets directory
+ */
+auto GetLabelsFile( LabelType labelType, dimension_t dimension ) -> std::string;
@@ -7,6 +7,8 @@
 #include <cassert>
 #include <vector>
 
+#include "group-store.hpp"
+#include "metrics.hpp"
 #include "spatial.hpp"
 
 using group_t = index_list_t;                         // A group of points, identified by the index of each point
@@ -90,6 +92,8 @@ bool GroupDominanceTest( ForwardGroupInterator first1
     // and skip the marked off points in subsequent loop iterations
     std::vector< bool > equal_to_point_in_group2( std::distance( first1, last1 ), false );
     bool groups_not_equal = false;
+    std::uint64_t num_point_tests = 0;
+    metrics::Add( metrics::Counter::group_dominance_tests );
     
     for( ; first2 != last2; ++first2 ) // iterate group 2 members
     {
@@ -104,6 +108,7 @@ bool GroupDominanceTest( ForwardGroupInterator first1
                 auto const it_curr_coords_end     = labels[ *curr1 ].cend();
                 auto const it_first2_coords_start = labels[ *first2 ].cbegin();
                 auto dominance_result = PointDominanceTest( it_curr_coords_start, it_curr_coords_end, it_first2_coords_start );
+                ++num_point_tests;
                 if( dominance_result == DominanceTestResult::equal )
                 {
                     // remove both of these points from subgroup 1 and subgroup 2, i.e., each big difference
@@ -127,28 +132,48 @@ bool GroupDominanceTest( ForwardGroupInterator first1
         {
             // we found a point in subgroup 2 that is not dominated by
             // a point in subgroup 1!
+            metrics::Add( metrics::Counter::point_dominance_tests, num_point_tests );
             return false;
         }
     }
     // if we get here, then all points in subgroup 2 were dominated by
     // some point in subgroup 1 or the groups are identical. Return
     // the groups_not_equal variable to differentiate the cases.
+    metrics::Add( metrics::Counter::point_dominance_tests, num_point_tests );
     return groups_not_equal;
 }
 
 /**
- * Returns true if any group in the skyline dominates the group_to_test
+ * Returns true if the i'th group of skyline dominates the j'th group of candidates.
+ * A group can only dominate another if its best virtual point is no worse than the other's in any dimension,
+ * because every member of the other must be dominated by or equal to one of its members; only groups that
+ * pass this test on the stored virtual points are compared member by member.
+ */
+inline
+bool GroupDominates( GroupStore const& skyline, std::size_t i, GroupStore const& candidates, std::size_t j, label_list_t const& coordinates )
+{
+    if( ! IsWeaklyBetter( skyline.Best( i ), candidates.Best( j ) ) )
+    {
+        return false;
+    }
+    auto const skylineGroup = skyline[ i ];
+    auto const group_to_test = candidates[ j ];
+    return GroupDominanceTest( std::cbegin( skylineGroup )
+                             , std::cend  ( skylineGroup )
+                             , std::cbegin( group_to_test )
+                             , std::cend  ( group_to_test )
+                             , coordinates );
+}
+
+/**
+ * Returns true if any group in the skyline dominates the index'th candidate
  */
 inline
-bool IsDominatedBySkyline( group_t const& group_to_test, group_list_t const& skyline, label_list_t const& coordinates )
+bool IsDominatedBySkyline( GroupStore const& candidates, std::size_t index, GroupStore const& skyline, label_list_t const& coordinates )
 {
-    for(auto const& skylineGroup : skyline )
+    for( std::size_t i = 0, n = skyline.size(); i < n; ++i )
     {
-        if( GroupDominanceTest( std::cbegin( skylineGroup )
-                              , std::cend  ( skylineGroup )
-                              , std::cbegin( group_to_test )
-                              , std::cend  ( group_to_test )
-                              , coordinates ) )
+        if( GroupDominates( skyline, i, candidates, index, coordinates ) )
         {
             return true;
         }
@@ -156,18 +181,23 @@ bool IsDominatedBySkyline( group_t const& group_to_test, group_list_t const& sky
     return false;
 }
 
+/**
+ * Returns true if any group in the skyline dominates the group_to_test
+ */
 inline
-bool IsDominatedByCandidates( point_index_t index, group_list_t const& candidates, std::vector< bool > const& bIsSkyline, label_list_t const& coordinates )
+bool IsDominatedBySkyline( group_t const& group_to_test, GroupStore const& skyline, label_list_t const& coordinates )
 {
-    auto it_index_start = candidates[ index ].cbegin();
-    auto it_index_end   = candidates[ index ].cend();
+    GroupStore candidate( skyline.GetGroupSize(), skyline.GetNumDimensions() );
+    candidate.Append( group_to_test, coordinates );
+    return IsDominatedBySkyline( candidate, 0, skyline, coordinates );
+}
 
+inline
+bool IsDominatedByCandidates( point_index_t index, GroupStore const& candidates, std::vector< bool > const& bIsSkyline, label_list_t const& coordinates )
+{
     for (size_t i = 0; i < static_cast<size_t>(index); i++) // no group can dominate groups preceding it
     {
-        auto it_i_start = candidates[ i ].cbegin();
-        auto it_i_end   = candidates[ i ].cend();
-
-        if (bIsSkyline[i] && GroupDominanceTest(it_i_start, it_i_end, it_index_start, it_index_end, coordinates))
+        if (bIsSkyline[i] && GroupDominates(candidates, i, candidates, index, coordinates))
         {
             return true;
         }
@@ -175,17 +205,37 @@ bool IsDominatedByCandidates( point_index_t index, group_list_t const& candidate
     return false;
 }
 
+/**
+ * Returns true if the worst virtual point of one of the skyline groups from position first onwards dominates
+ * a point that is no worse than every member of some groups, e.g., their best virtual point. Every member of such
+ * a skyline group then dominates every member of those groups, so none of them can be in the skyline.
+ */
 inline
-bool CanTerminate( label_list_t const& skylineRepresentatives, vertex_label_t const& layerRepresentative)
+bool CanTerminate( GroupStore const& skyline, GroupStore::point_view_t const point, std::size_t const first = 0 )
 {
-    for (const myLabel& skyRep : skylineRepresentatives)
+    std::uint64_t num_point_tests = 0;
+    for (size_t i = first, n = skyline.size(); i < n; ++i)
     {
+        ++num_point_tests;
+        auto const skyRep = skyline.Worst( i );
         if( DominanceTestResult::dominates == PointDominanceTest( std::cbegin( skyRep )
                                                                 , std::cend  ( skyRep )
-                                                                , std::cbegin( layerRepresentative ) ) )
+                                                                , std::cbegin( point ) ) )
         {
+            metrics::Add( metrics::Counter::point_dominance_tests, num_point_tests );
             return true;
         }
     }
+    metrics::Add( metrics::Counter::point_dominance_tests, num_point_tests );
     return false;
 }
+
+/**
+ * Returns true if the worst virtual point of some skyline group dominates the representative
+ * of a sky layer, i.e., no group with a member in that layer or beyond can be in the skyline
+ */
+inline
+bool CanTerminate( GroupStore const& skyline, vertex_label_t const& layerRepresentative)
+{
+    return CanTerminate( skyline, GroupStore::point_view_t( layerRepresentative ) );
+}
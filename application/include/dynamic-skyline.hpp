@@ -0,0 +1,168 @@
+/**
+ * Maintenance of the result of a skyline community query while the graph changes,
+ * so that each batch of updates costs work in proportion to the groups it can affect.
+ */
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "graph.hpp"
+#include "group-store.hpp"
+#include "skyline-engine.hpp"
+
+namespace base
+{
+
+using edge_t = std::pair< vertex_id_t, vertex_id_t >;
+
+/**
+ * Edges to insert into and delete from a graph, in the vertex ids of the input files. Deletions are applied
+ * first. Inserting an edge that exists, deleting one that does not, and self-loops are ignored.
+ */
+struct EdgeBatch
+{
+    std::vector< edge_t > insertions;
+    std::vector< edge_t > deletions;
+};
+
+/**
+ * A new label for a vertex, in the vertex ids of the input files and the dimensions of the queried (sub)space
+ */
+struct LabelUpdate
+{
+    vertex_id_t vertex;
+    vertex_label_t label;
+};
+
+/**
+ * The groups that entered and left a skyline with one batch of updates, in the vertex ids of the input files
+ */
+struct SkylineDelta
+{
+    group_list_t added;
+    group_list_t removed;
+};
+
+/**
+ * The skyline of one query over a graph that is updated in batches. Computed once with the query's engine,
+ * it is then maintained from the vertices that updates can affect:
+ *   - a group that contains an inserted edge lies within the neighbourhood of both its endpoints, and
+ *   - a group that returns to the skyline because a deleted edge broke one that dominated it, or because
+ *     a label update worsened one, lies in the region of label space that that group's best virtual point dominates, and
+ *   - a group whose own labels changed lies within the neighbourhood of each updated member.
+ * Only those vertices are admitted to a rerun of the engine (see VertexFilter), whose groups are merged
+ * into the surviving skyline; dominance tests are limited to pairs of a surviving and a new group. Membership
+ * in the coreSize-core is maintained incrementally, so updates outside it are dismissed without a rerun.
+ * Label updates also maintain the vertex order that the engines rely on, in which no vertex is dominated by one
+ * with a larger id and vertices with equal labels are adjacent, and lower the representative of each layer to
+ * cover the updated labels from it onwards.
+ */
+class DynamicSkyline
+{
+public:
+
+    /**
+     * Copies the graph of an engine, or of the subspace that the query names, and computes the initial skyline
+     * @throws std::invalid_argument if the query is invalid or asks for the baseline, which is not supported
+     */
+    DynamicSkyline( SkylineEngine const& engine, SkylineQuery query );
+
+    /**
+     * Applies a batch of edge updates to the graph and brings the skyline up to date
+     * @throws std::invalid_argument if an update names a vertex that is not in the graph
+     */
+    auto ApplyEdgeUpdates( EdgeBatch const& batch ) -> SkylineDelta;
+
+    /**
+     * Applies a batch of label updates, in order, and brings the skyline up to date. A vertex whose new label
+     * breaks the vertex order is moved to the nearest position that restores it, renumbering the vertices in
+     * between, and representatives are lowered to cover it. If a batch moves vertices too far in total,
+     * the graph is preprocessed and the skyline computed from scratch instead.
+     * @throws std::invalid_argument if an update names a vertex that is not in the graph or has the wrong dimension
+     */
+    auto ApplyLabelUpdates( std::vector< LabelUpdate > const& updates ) -> SkylineDelta;
+
+    /**
+     * The current skyline, in the vertex ids of the input files
+     */
+    auto GetSkyline() const -> group_list_t;
+
+    /**
+     * The graph in its current state, with relabelled vertex ids
+     */
+    auto GetGraph() const -> Graph const& { return m_graph; }
+
+private:
+
+    auto ToRelabelled( vertex_id_t original ) const -> vertex_id_t;
+
+    /**
+     * Computes the core membership of every vertex from scratch
+     */
+    void InitialiseCore();
+
+    /**
+     * Adds or removes an edge in both adjacency lists and updates the core; returns false if nothing changed
+     */
+    bool InsertEdge( vertex_id_t u, vertex_id_t v );
+    bool DeleteEdge( vertex_id_t u, vertex_id_t v );
+
+    /**
+     * Removes from the core the vertices of a queue that, and then those of their neighbours that, lack support
+     */
+    void PeelFromCore( vertex_list_t queue );
+
+    /**
+     * Adds to the core the vertices around the given non-core vertices that the core together with them can support
+     */
+    void GrowCore( vertex_list_t const& roots );
+
+    /**
+     * Moves a vertex whose label changed to the nearest position where no vertex after it dominates it, it dominates
+     * none before it and, if other vertices have the same label, it is next to them, or else not between two that do.
+     * Lowers the representatives of the layers it now belongs to. Returns the number of positions it moved.
+     */
+    auto Reposition( vertex_id_t vertex ) -> std::size_t;
+
+    /**
+     * Gives vertex from the id to, shifting the ids in between by one towards from, in the graph, the core and the skyline
+     */
+    void MoveVertex( vertex_id_t from, vertex_id_t to );
+
+    /**
+     * Lowers the representative of every layer that starts no later than position to be no worse than label
+     */
+    void LowerRepresentatives( vertex_id_t position, vertex_label_t const& label );
+
+    /**
+     * Preprocesses the graph afresh with its current labels and recomputes the skyline
+     */
+    auto Rebuild() -> SkylineDelta;
+
+    /**
+     * Core vertices that are no more than the query's number of hops from u through core vertices, in ascending order
+     */
+    auto GetCoreNeighbourhood( vertex_id_t u ) const -> vertex_list_t;
+
+    /**
+     * Runs the query's engine on the admitted vertices only
+     */
+    auto Compute( std::vector< char > const& admitted ) const -> GroupStore;
+
+    /**
+     * Replaces the groups of the skyline that keep[i] does not flag, merges in the groups of a rerun
+     * that no surviving group dominates, and returns the difference
+     */
+    auto Merge( std::vector< bool > keep, GroupStore const& candidates ) -> SkylineDelta;
+
+    Graph m_graph;
+    SkylineQuery m_query;
+    std::vector< char > m_filter;            // the query's vertex filter, per vertex; empty if it has none
+    vertex_list_t m_in_core;                 // 1 for each vertex in the coreSize-core
+    vertex_degree_list_t m_core_degree;      // number of neighbours of each vertex that are in the core
+    GroupStore m_skyline;                    // in relabelled ids, each group in ascending order
+};
+
+} // namespace base
@@ -0,0 +1,68 @@
+/**
+ * Synthetic graphs and vertex labels for scale testing. Every generator is deterministic in its seed,
+ * independent of the number of OpenMP threads it runs on: work is cut into fixed-size chunks that
+ * each draw from their own generator, seeded from the global seed and the chunk index.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "graph.hpp"
+
+namespace generators
+{
+
+using edge_t = std::pair< vertex_id_t, vertex_id_t >;
+using edge_list_t = std::vector< edge_t >;
+
+/**
+ * R-MAT graph (Chakrabarti et al. 2004): each edge recursively picks a quadrant of the adjacency
+ * matrix with probabilities a, b, c and 1 - a - b - c. Defaults are those of Graph500.
+ */
+struct RmatParameters
+{
+    double a = 0.57;
+    double b = 0.19;
+    double c = 0.19;
+};
+
+auto GenerateRmat( vertex_id_t num_vertices, double average_degree, RmatParameters const& parameters, std::uint64_t seed ) -> edge_list_t;
+
+/**
+ * Chung-Lu graph: the expected degree of each vertex follows a power law with the given exponent,
+ * scaled to the given average degree. Vertex 0 has the highest expected degree.
+ */
+auto GenerateChungLu( vertex_id_t num_vertices, double average_degree, double exponent, std::uint64_t seed ) -> edge_list_t;
+
+/**
+ * Graph with planted communities: vertices are split into num_communities blocks of consecutive ids,
+ * and each edge joins two vertices of the same block with probability 1 - mixing, or two arbitrary
+ * vertices otherwise.
+ */
+auto GeneratePlantedCommunities( vertex_id_t num_vertices, double average_degree, vertex_id_t num_communities, double mixing, std::uint64_t seed ) -> edge_list_t;
+
+/**
+ * Labels following makeIndepLabels, makeCorrLabels and makeAnticorrLabels of datasets/preprocessing.ipynb:
+ * integer coordinates in [low, high), respectively between low and high after min-max scaling per dimension.
+ */
+auto GenerateIndependentLabels   ( vertex_id_t num_vertices, dimension_t num_dimensions, std::uint64_t seed, coordinate_t low = 0, coordinate_t high = 100 ) -> label_list_t;
+auto GenerateCorrelatedLabels    ( vertex_id_t num_vertices, dimension_t num_dimensions, std::uint64_t seed, coordinate_t low = 0, coordinate_t high = 100, double scale = 0.5 ) -> label_list_t;
+auto GenerateAnticorrelatedLabels( vertex_id_t num_vertices, dimension_t num_dimensions, std::uint64_t seed, coordinate_t low = 0, coordinate_t high = 100 ) -> label_list_t;
+
+/**
+ * Builds adjacency lists sorted in ascending order, as LoadEdges does
+ */
+auto ToAdjacencyList( edge_list_t const& edges, vertex_id_t num_vertices ) -> adjacency_list_t;
+
+/**
+ * Write in the formats read by LoadEdges and LoadLabels, binary if the file has the extension .bin (see IsBinaryFile).
+ * Return false if the file cannot be written.
+ */
+bool WriteEdges ( std::string const& filePath, edge_list_t const& edges );
+bool WriteLabels( std::string const& filePath, label_list_t const& labels );
+
+} // namespace generators
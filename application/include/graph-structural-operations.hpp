@@ -3,6 +3,7 @@
 #include <optional>
 
 #include "graph.hpp"
+#include "intersection.hpp"
 
 
 template < typename ForwardIterator1, typename ForwardIterator2 >
@@ -19,19 +20,12 @@ auto GetIntersection( ForwardIterator1 group1_start
 }
 
 
-inline
-void GetIntersection( vertex_list_t const& group1, vertex_list_t const& group2, vertex_list_t & result )
-{
-    // assuming both vectors are sorted
-    result.clear();
-    result.reserve(std::min(group1.size(), group2.size()));
-    std::set_intersection(group1.cbegin(), group1.cend(), group2.cbegin(), group2.cend(), std::back_inserter(result));
-}
-
 inline
 auto GetIntersection( vertex_list_t const& group1, vertex_list_t const& group2 ) -> vertex_list_t
 {
-	return GetIntersection( std::cbegin( group1 ), std::cend( group1 ), std::cbegin( group2 ), std::cend( group2 ) );
+    vertex_list_t result;
+    GetIntersection( group1, group2, result );
+    return result;
 }
 
 /**
@@ -113,3 +107,26 @@ bool IsConnectedKCore( vertex_list_t const& vertex_subset, adjacency_list_t cons
     }
     return true;
 }
+
+/**
+ * Minimum number of common neighbours of two adjacent vertices in any group of groupSize vertices and minimum degree coreSize:
+ * each has at least coreSize - 1 neighbours among the other groupSize - 2 vertices. Two non-adjacent members need two more.
+ */
+constexpr
+auto GetMinCommonNeighbours( vertex_degree_t groupSize, vertex_degree_t coreSize ) -> vertex_degree_t
+{
+    return 2 * coreSize - groupSize;
+}
+
+/**
+ * Reduces a neighbourhood of nodes[0], as found by GetKHopNeighbourhood, to the vertices that can be in a group of
+ * groupSize vertices and minimum degree coreSize together with nodes[0]. Repeatedly removes vertices that have
+ * fewer than coreSize neighbours left, or fewer common neighbours with nodes[0] than GetMinCommonNeighbours
+ * requires. Then, unless groups are cliques, repeats this ignoring edges whose endpoints have too few common
+ * neighbours among the remaining vertices to share a group; no work is spent on neighbourhoods that are not visited.
+ * Returns the remaining vertices in the order of nodes, or an empty list if fewer than groupSize remain.
+ */
+auto ReduceToFeasibleCore( vertex_list_t const& nodes
+                         , adjacency_list_t const& edges
+                         , vertex_degree_t groupSize
+                         , vertex_degree_t coreSize ) -> vertex_list_t;
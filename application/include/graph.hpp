@@ -5,6 +5,7 @@
 #pragma once
 
 #include <cassert>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -35,8 +36,34 @@ struct Graph
 };
 
 void UpdateGraph( Graph & myGraph );
-bool LoadEdges (const std::string& filePath, intVec2D& edges, int nodeSize); 
-bool LoadLabels(const std::string& filePath, myLabelVec& labels, int nodeSize); 
+
+/**
+ * Whether a file is in the binary format, i.e., has the extension .bin. Otherwise it is CSV:
+ *   - edges: one "u,v" line per undirected edge
+ *   - labels: one line of comma-separated integer coordinates per vertex, in order of vertex id
+ * Binary files start with two little-endian 64-bit integers, followed by 32-bit integers:
+ *   - edges: the number of vertices and of edges, then the two endpoints of each edge
+ *   - labels: the number of vertices and of dimensions, then the coordinates of each vertex
+ */
+bool IsBinaryFile( std::string const& filePath );
+
+/**
+ * Load edges into ascending adjacency lists, and labels, from CSV or binary files in a single pass.
+ * Without a nodeSize, the number of vertices is taken from the file (one more than the largest vertex id
+ * of an edge, or the number of labels) and the dimension of labels from the first label. With a nodeSize,
+ * edges with an endpoint >= nodeSize and labels past the first nodeSize are dropped, and a label file
+ * with fewer labels is malformed.
+ * Return false, having reported why, if a file cannot be read or is malformed. Throw std::runtime_error
+ * if the header of a binary file gives counts that overflow or that the size of the file does not match.
+ */
+bool LoadEdges ( std::string const& filePath, adjacency_list_t & edges, std::optional< vertex_id_t > nodeSize = std::nullopt );
+bool LoadLabels( std::string const& filePath, label_list_t & labels, std::optional< vertex_id_t > nodeSize = std::nullopt );
+
+/**
+ * Loads both files of a graph. Its size is the given nodeSize or, without one, one more than the largest
+ * vertex id of an edge; only that many labels are read. Fails if a vertex is unlabelled.
+ */
+bool LoadGraph( std::string const& edgesFilePath, std::string const& labelsFilePath, Graph & graph, std::optional< vertex_id_t > nodeSize = std::nullopt );
 
 /**
  * Sorts the vertices by degree using "Bin Sort" and returns the three objects---sortedIndices,
@@ -1,8 +1,10 @@
 #pragma once
 
+#include <span>
+
 #include "graph.hpp"
 #include "spatial.hpp"
 
-auto GetAverageVirtualPoint( vertex_list_t const& group, label_list_t const& labels ) -> vertex_label_t;
-auto GetBestVirtualPoint   ( vertex_list_t const& group, label_list_t const& labels ) -> vertex_label_t;
-auto GetWorstVirtualPoint  ( vertex_list_t const& group, label_list_t const& labels ) -> vertex_label_t;
+auto GetAverageVirtualPoint( std::span< vertex_id_t const > group, label_list_t const& labels ) -> vertex_label_t;
+auto GetBestVirtualPoint   ( std::span< vertex_id_t const > group, label_list_t const& labels ) -> vertex_label_t;
+auto GetWorstVirtualPoint  ( std::span< vertex_id_t const > group, label_list_t const& labels ) -> vertex_label_t;
@@ -0,0 +1,190 @@
+/**
+ * Flat storage for lists of equally-sized groups, such as skylines and candidate sets.
+ */
+
+#pragma once
+
+#include <compare>
+#include <cstdint>
+#include <iterator>
+#include <span>
+#include <vector>
+
+#include "memory-accounting.hpp"
+#include "spatial.hpp"
+
+/**
+ * A list of groups of a fixed size g, stored contiguously with a stride of g members, together with
+ * the best and worst virtual point of each group in two further arrays with a stride of the label
+ * dimension. Appending a group costs no allocation once capacity is reserved, and a scan over all
+ * groups, e.g., a dominance test against a skyline, streams linearly through memory.
+ * Groups keep their order under every operation.
+ */
+class GroupStore
+{
+public:
+
+    using group_view_t = std::span< point_index_t const >;
+    using point_view_t = std::span< coordinate_t const >;
+
+    /**
+     * Random-access iterator over the groups of a store that yields a view of each group
+     */
+    class const_iterator
+    {
+    public:
+
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type        = group_view_t;
+        using difference_type   = std::ptrdiff_t;
+        using reference         = group_view_t;
+        using pointer           = void;
+
+        const_iterator() = default;
+        const_iterator( GroupStore const* groups, std::size_t index ) : m_groups( groups ), m_index( index ) {}
+
+        auto operator *  () const -> group_view_t { return ( *m_groups )[ m_index ]; }
+        auto operator [] ( difference_type n ) const -> group_view_t { return ( *m_groups )[ m_index + n ]; }
+
+        auto operator ++ () -> const_iterator & { ++m_index; return *this; }
+        auto operator -- () -> const_iterator & { --m_index; return *this; }
+        auto operator ++ ( int ) -> const_iterator { auto const previous = *this; ++m_index; return previous; }
+        auto operator -- ( int ) -> const_iterator { auto const previous = *this; --m_index; return previous; }
+        auto operator += ( difference_type n ) -> const_iterator & { m_index += n; return *this; }
+        auto operator -= ( difference_type n ) -> const_iterator & { m_index -= n; return *this; }
+
+        friend auto operator + ( const_iterator it, difference_type n ) -> const_iterator { return it += n; }
+        friend auto operator + ( difference_type n, const_iterator it ) -> const_iterator { return it += n; }
+        friend auto operator - ( const_iterator it, difference_type n ) -> const_iterator { return it -= n; }
+        friend auto operator - ( const_iterator const& left, const_iterator const& right ) -> difference_type
+        {
+            return static_cast< difference_type >( left.m_index ) - static_cast< difference_type >( right.m_index );
+        }
+        friend bool operator == ( const_iterator const& left, const_iterator const& right ) { return left.m_index == right.m_index; }
+        friend auto operator <=> ( const_iterator const& left, const_iterator const& right ) { return left.m_index <=> right.m_index; }
+
+        /**
+         * Position of the group in its store
+         */
+        auto GetIndex() const -> std::size_t { return m_index; }
+
+    private:
+
+        GroupStore const* m_groups = nullptr;
+        std::size_t m_index = 0;
+    };
+
+    GroupStore() = default;
+
+    GroupStore( std::size_t groupSize, std::size_t numDimensions )
+        : m_group_size( groupSize )
+        , m_num_dimensions( numDimensions )
+    {}
+
+    auto size() const -> std::size_t { return m_num_groups; }
+    bool empty() const { return m_num_groups == 0; }
+    auto GetGroupSize() const -> std::size_t { return m_group_size; }
+    auto GetNumDimensions() const -> std::size_t { return m_num_dimensions; }
+
+    auto begin()  const -> const_iterator { return { this, 0 }; }
+    auto end()    const -> const_iterator { return { this, m_num_groups }; }
+    auto cbegin() const -> const_iterator { return begin(); }
+    auto cend()   const -> const_iterator { return end(); }
+
+    auto operator [] ( std::size_t i ) const -> group_view_t
+    {
+        return { m_members.data() + i * m_group_size, m_group_size };
+    }
+
+    /**
+     * Componentwise maximum of the labels of the i'th group's members
+     */
+    auto Worst( std::size_t i ) const -> point_view_t
+    {
+        return { m_worst.data() + i * m_num_dimensions, m_num_dimensions };
+    }
+
+    /**
+     * Componentwise minimum of the labels of the i'th group's members
+     */
+    auto Best( std::size_t i ) const -> point_view_t
+    {
+        return { m_best.data() + i * m_num_dimensions, m_num_dimensions };
+    }
+
+    void reserve( std::size_t numGroups );
+    void clear();
+
+    /**
+     * Appends a group, computing its virtual points from the labels of its members
+     * @pre group has exactly GetGroupSize() members
+     */
+    void Append( group_view_t group, label_list_t const& labels );
+
+    /**
+     * Appends the i'th group of another store of the same shape, along with its virtual points
+     */
+    void Append( GroupStore const& groups, std::size_t i );
+
+    /**
+     * Grows or shrinks the store to numGroups groups; new groups are zero-filled until overwritten with Place()
+     */
+    void Resize( std::size_t numGroups );
+
+    /**
+     * Overwrites the groups from position onwards with all groups of another store of the same shape
+     * @pre position + groups.size() <= size()
+     */
+    void Place( std::size_t position, GroupStore const& groups );
+
+    /**
+     * Removes every group i for which keep[i] is false, preserving the order of the rest. Linear in the size of the store.
+     */
+    void Compact( std::vector< bool > const& keep );
+
+    /**
+     * Copies the groups out into one list per group, e.g., to return them from a query
+     */
+    auto ToGroupList() const -> std::vector< index_list_t >;
+
+    /**
+     * Bytes held by the store's buffers, by capacity
+     */
+    auto GetCapacityBytes() const -> std::int64_t;
+
+private:
+
+    std::size_t m_group_size = 0;
+    std::size_t m_num_dimensions = 0;
+    std::size_t m_num_groups = 0;
+    std::vector< point_index_t > m_members; // m_group_size per group
+    std::vector< coordinate_t > m_worst;    // m_num_dimensions per group
+    std::vector< coordinate_t > m_best;     // m_num_dimensions per group
+};
+
+/**
+ * Whether a point is smaller than or equal to another in every dimension
+ */
+inline
+bool IsWeaklyBetter( GroupStore::point_view_t left, GroupStore::point_view_t right )
+{
+    for( std::size_t d = 0, n = left.size(); d < n; ++d )
+    {
+        if( right[ d ] < left[ d ] )
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+namespace memory
+{
+
+inline
+auto BytesOf( GroupStore const& groups ) -> std::int64_t
+{
+    return accounting_enabled ? groups.GetCapacityBytes() : 0;
+}
+
+} // namespace memory
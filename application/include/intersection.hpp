@@ -0,0 +1,59 @@
+/**
+ * Kernels for intersecting sorted lists of vertices, such as adjacency lists, tailsets, and groups.
+ */
+
+#pragma once
+
+#include <span>
+
+#include "graph.hpp"
+
+using sorted_view_t = std::span< vertex_id_t const >; // a list of distinct vertices in ascending order
+
+/**
+ * Ways to intersect two sorted lists. The adaptive choice of ChooseIntersectionKernel suffices for callers;
+ * the others are exposed so that they can be benchmarked against each other.
+ */
+enum class IntersectionKernel
+{
+    merge,       // scalar merge of both lists; the fallback for short lists
+    block_merge, // compares blocks of eight vertices of each list at once with AVX2, where compiled in; else as merge
+    galloping    // exponential search in the longer list for each vertex of the shorter, for lists of very different sizes
+};
+
+/**
+ * Picks the kernel expected to be fastest for lists of the given sizes
+ */
+auto ChooseIntersectionKernel( std::size_t size1, std::size_t size2 ) -> IntersectionKernel;
+
+/**
+ * Overwrites result with the vertices in both group1 and group2, in ascending order.
+ * result may be the vector that group2 views, which is then intersected in place.
+ */
+void GetIntersection( sorted_view_t group1, sorted_view_t group2, vertex_list_t & result, IntersectionKernel kernel );
+
+inline
+void GetIntersection( sorted_view_t group1, sorted_view_t group2, vertex_list_t & result )
+{
+    GetIntersection( group1, group2, result, ChooseIntersectionKernel( group1.size(), group2.size() ) );
+}
+
+/**
+ * Number of vertices in both group1 and group2, without materialising them
+ */
+auto CountIntersection( sorted_view_t group1, sorted_view_t group2 ) -> std::size_t;
+
+/**
+ * Overwrites result with the vertices of group that are in neighbours, in ascending order.
+ * result may be the vector that group views, which is then intersected in place.
+ *
+ * @pre neighbours are sorted in descending order, as in an adjacency list
+ */
+void GetNeighboursIn( vertex_list_t const& neighbours, sorted_view_t group, vertex_list_t & result );
+
+/**
+ * Number of vertices of group that are in neighbours, i.e., the degree of a vertex within group
+ *
+ * @pre neighbours are sorted in descending order, as in an adjacency list
+ */
+auto CountNeighboursIn( vertex_list_t const& neighbours, sorted_view_t group ) -> std::size_t;
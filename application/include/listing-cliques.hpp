@@ -0,0 +1,26 @@
+/**
+ * Listing of fixed-size cliques, i.e., of size-g k-cores with coreSize = g - 1, without the
+ * missed-connection bookkeeping that cousins-first listing needs for general k-plexes.
+ */
+
+#pragma once
+
+#include "graph.hpp"
+#include "group-store.hpp"
+
+namespace base {
+namespace listing {
+namespace cliques {
+
+/**
+ * Appends to a store all cliques of cliqueSize vertices that consist of nodes[0] and other vertices of nodes,
+ * in the same order as cousins_first::ListKCoresWithPrefix. The graph is oriented from smaller to larger ids, i.e.,
+ * in the engine's processing order, and the neighbourhood is held as one bitset of out-neighbours per vertex,
+ * so that each extension of a clique costs one word-wise intersection of candidate sets.
+ * @pre nodes are sorted in ascending order and neighbours in descending order
+ */
+void ListCliquesWithPrefix( vertex_list_t const& nodes, adjacency_list_t const& edges, int cliqueSize, label_list_t const& labels, GroupStore & cliques );
+
+} // namespace cliques
+} // namespace listing
+} // namespace base
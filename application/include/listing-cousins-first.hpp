@@ -6,6 +6,7 @@
 #pragma once
 
 #include "graph.hpp"
+#include "group-store.hpp"
 
 using group_t = index_list_t;                         // A group of points, identified by the index of each point
 using group_list_t = std::vector< index_list_t >;     // A group of groups
@@ -15,19 +16,34 @@ namespace base {
 namespace listing {
 namespace cousins_first {
 
+/**
+ * How branches of the enumeration are cut before they have grown to groupSize vertices
+ */
+enum class Bound
+{
+    tailset_size, // only if the group and all of its tailset are fewer than groupSize vertices
+    colouring     // if a greedy colouring of the neighbourhood shows that no extension can reach groupSize vertices
+};
+
 /**
  * Given a set of nodes that define a subgraph to induce on a given adjacency list, returns an ordered list of
  * all k-cores of a specific size, predicated on containing the first node. That is to say, it returns all subsets
  * S of (nodes.begin+1 .... nodes.end) of size groupSize - 1 for which (S union {nodes[0]}) induces a subgraph on
  * edges in which the minimum degree is coreSize.
  */
-auto ListKCoresWithPrefix( vertex_list_t const& nodes, adjacency_list_t const& edges, int groupSize, int coreSize ) -> group_list_t;
+auto ListKCoresWithPrefix( vertex_list_t const& nodes, adjacency_list_t const& edges, int groupSize, int coreSize, Bound bound = Bound::colouring ) -> group_list_t;
+
+/**
+ * As above, but appends the k-cores, in the same order, to a store of groups of size groupSize,
+ * which computes their virtual points from the given labels
+ */
+void ListKCoresWithPrefix( vertex_list_t const& nodes, adjacency_list_t const& edges, int groupSize, int coreSize, label_list_t const& labels, GroupStore & kcores, Bound bound = Bound::colouring );
 
 /**
  * Returns an ordered list of **all** subsets of a given graph that have groupSize vertices and a minimum degree
  * of coreSize, i.e., all size-g k-cores.
  */
-auto ListAllKCores( adjacency_list_t edges, int groupSize, int coreSize ) -> group_list_t;
+auto ListAllKCores( adjacency_list_t edges, int groupSize, int coreSize, Bound bound = Bound::colouring ) -> group_list_t;
 
 } // namespace cousins_first
 } // namespace listing
@@ -0,0 +1,161 @@
+/**
+ * Opt-in memory accounting: a counting replacement of the global allocator, and byte gauges for the
+ * structures that dominate the footprint of a query (graph, labels, sky layers, neighbourhoods,
+ * candidates and skyline), each with its current size and high-water mark.
+ * Allocator and gauges are compiled to no-ops unless KSKYCORE_MEMORY_ACCOUNTING is defined;
+ * the peak resident set size of the process is always available.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace memory
+{
+
+enum class Subsystem
+{
+    graph,         // adjacency lists, including working copies that queries shrink
+    labels,
+    sky_layers,    // sky layers while they are built, their boundaries and representatives
+    neighbourhood, // k-hop neighbourhoods and their visited sets
+    candidates,    // groups listed for a vertex that await dominance filtering
+    skyline,       // skyline groups and their representatives
+    count_ // number of subsystems; not a subsystem
+};
+
+auto ToString( Subsystem subsystem ) -> char const*;
+
+constexpr std::size_t num_subsystems = static_cast< std::size_t >( Subsystem::count_ );
+
+#ifdef KSKYCORE_MEMORY_ACCOUNTING
+constexpr bool accounting_enabled = true;
+#else
+constexpr bool accounting_enabled = false;
+#endif
+
+struct Gauge
+{
+    std::int64_t current_bytes = 0;
+    std::int64_t peak_bytes = 0;
+};
+
+/**
+ * Traffic through the global allocator
+ */
+struct HeapStats
+{
+    std::int64_t live_bytes = 0;
+    std::int64_t peak_bytes = 0;
+    std::uint64_t allocated_bytes = 0;
+    std::uint64_t allocations = 0;
+};
+
+/**
+ * Snapshot of all memory accounting. Heap and gauges are zero unless accounting is compiled in.
+ */
+struct Usage
+{
+    HeapStats heap;
+    std::array< Gauge, num_subsystems > subsystems = {};
+    std::int64_t peak_rss_kb = 0;
+};
+
+/**
+ * Adds a (possibly negative) number of bytes to a gauge; thread-safe
+ */
+void AddBytes( Subsystem subsystem, std::int64_t bytes );
+
+inline
+void Add( [[maybe_unused]] Subsystem subsystem, [[maybe_unused]] std::int64_t bytes )
+{
+#ifdef KSKYCORE_MEMORY_ACCOUNTING
+    AddBytes( subsystem, bytes );
+#endif
+}
+
+/**
+ * High-water mark of heap bytes allocated through the global allocator since the last ResetPeaks()
+ */
+auto PeakHeapBytes() -> std::int64_t;
+
+/**
+ * High-water mark of the resident set size over the lifetime of the process, in kilobytes
+ */
+auto PeakResidentKilobytes() -> std::int64_t;
+
+auto Collect() -> Usage;
+
+/**
+ * Lowers every high-water mark to the current value. Should not be called while a query is running.
+ */
+void ResetPeaks();
+
+/**
+ * Bytes held by the buffers of a (nested) vector, by capacity. Always zero unless accounting is compiled in,
+ * so that callers can pass it to Add() without paying for the traversal.
+ */
+inline
+auto BytesOf( std::vector< bool > const& bits ) -> std::int64_t
+{
+    return accounting_enabled ? bits.capacity() / 8 : 0;
+}
+
+template < typename T >
+auto BytesOf( std::vector< T > const& elements ) -> std::int64_t
+{
+    return accounting_enabled ? elements.capacity() * sizeof( T ) : 0;
+}
+
+template < typename T >
+auto BytesOf( std::vector< std::vector< T > > const& lists ) -> std::int64_t
+{
+    if constexpr( ! accounting_enabled )
+    {
+        return 0;
+    }
+    std::int64_t bytes = lists.capacity() * sizeof( std::vector< T > );
+    for( auto const& list : lists )
+    {
+        bytes += BytesOf( list );
+    }
+    return bytes;
+}
+
+/**
+ * RAII charge of a number of bytes to a gauge for its own lifetime; the charge can be adjusted as the structure changes size
+ */
+class ScopedBytes
+{
+public:
+
+    explicit ScopedBytes( Subsystem subsystem, std::int64_t bytes = 0 )
+        : m_subsystem( subsystem )
+        , m_bytes( bytes )
+    {
+        Add( m_subsystem, m_bytes );
+    }
+
+    ~ScopedBytes()
+    {
+        Add( m_subsystem, -m_bytes );
+    }
+
+    void Set( std::int64_t bytes )
+    {
+        Add( m_subsystem, bytes - m_bytes );
+        m_bytes = bytes;
+    }
+
+    ScopedBytes( ScopedBytes const& ) = delete;
+    ScopedBytes & operator = ( ScopedBytes const& ) = delete;
+
+private:
+
+    Subsystem m_subsystem;
+    std::int64_t m_bytes;
+};
+
+} // namespace memory
@@ -0,0 +1,278 @@
+/**
+ * Process-wide instrumentation: per-phase timers and event counters that are recorded
+ * thread-locally without synchronisation and aggregated on demand into a Report.
+ * Phases can additionally be charged with hardware performance counters where available, and with
+ * memory high-water marks if memory accounting is compiled in (see memory-accounting.hpp).
+ * Compiled to no-ops unless KSKYCORE_METRICS is defined.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "memory-accounting.hpp"
+#include "perf-counters.hpp"
+
+namespace metrics
+{
+
+enum class Phase
+{
+    load,
+    partition,
+    sky_layers,
+    initial_peel,
+    neighbourhood,
+    listing,
+    dominance_filtering,
+    postprocess,
+    count_ // number of phases; not a phase
+};
+
+enum class Counter
+{
+    vertices_pruned_by_kcore,
+    vertices_excluded_by_filter,
+    vertices_pruned_by_structure,
+    vertices_skipped_by_termination,
+    vertices_skipped_by_suffix,
+    suffix_termination_tests,
+    candidates_listed,
+    branches_pruned_by_colouring,
+    group_dominance_tests,
+    point_dominance_tests,
+    parallel_rounds,
+    count_ // number of counters; not a counter
+};
+
+auto ToString( Phase phase ) -> char const*;
+auto ToString( Counter counter ) -> char const*;
+
+constexpr std::size_t num_phases   = static_cast< std::size_t >( Phase::count_ );
+constexpr std::size_t num_counters = static_cast< std::size_t >( Counter::count_ );
+
+/**
+ * Accumulated cost of one phase on one thread (or summed over all threads)
+ */
+struct PhaseStats
+{
+    std::uint64_t nanoseconds = 0;
+    std::uint64_t invocations = 0;
+    HardwareCounts hardware = {}; // zero unless hardware counters are enabled and available
+    std::int64_t peak_heap_bytes = 0; // high-water marks seen when the phase ended;
+    std::int64_t peak_rss_kb = 0;     // zero unless memory accounting is compiled in
+};
+
+/**
+ * Everything recorded by a single thread. Only ever written by its owner.
+ */
+struct ThreadMetrics
+{
+    std::array< std::uint64_t, num_counters > counters = {};
+    std::array< PhaseStats, num_phases > phases = {};
+};
+
+/**
+ * A snapshot of the skyline size at some point of a query
+ */
+struct SkylineSample
+{
+    std::uint64_t elapsed_microseconds;
+    std::int64_t vertex;
+    std::uint64_t skyline_size;
+};
+
+/**
+ * What one query recorded beyond counters: where its scan terminated and how its skyline grew. Owned by the
+ * caller and passed to the engine through the QueryContext, so that concurrent queries keep separate records.
+ * Only written from sequential sections of the query.
+ */
+struct QueryRecord
+{
+    std::int64_t termination_layer = -1; // -1 if the scan did not terminate early
+    std::vector< SkylineSample > skyline_size;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+};
+
+/**
+ * Aggregated view of all metrics recorded since the last Reset(), and of one query's record
+ */
+struct Report
+{
+    ThreadMetrics totals;
+    std::vector< ThreadMetrics > per_thread;
+    std::int64_t termination_layer = -1; // as in the query's record; -1 if there is none
+    std::vector< SkylineSample > skyline_size;
+    std::array< bool, num_hardware_events > hardware_events_available = {};
+    memory::Usage memory;
+};
+
+/**
+ * Returns the calling thread's metrics, registering them on first use. When the thread exits, its slot and
+ * what was recorded in it are handed on to the next thread that registers, so that a process that keeps
+ * starting threads holds no more slots than it ever ran threads at once.
+ */
+auto RegisterThread() -> ThreadMetrics *;
+
+/**
+ * Switches on reading hardware performance counters around every phase. Off by default because
+ * each read costs a system call. Threads for which counters cannot be opened fall back to wall-clock time.
+ */
+void SetHardwareCountersEnabled( bool enabled );
+bool AreHardwareCountersEnabled();
+
+/**
+ * Returns the calling thread's hardware counters, opening them on first use,
+ * or nullptr if they are disabled or unavailable
+ */
+auto RegisterThreadCounters() -> PerfCounterGroup const*;
+
+inline thread_local ThreadMetrics * t_local = nullptr;
+inline thread_local PerfCounterGroup const* t_counters = nullptr;
+inline thread_local bool t_counters_opened = false;
+
+inline
+auto LocalCounters() -> PerfCounterGroup const*
+{
+    if( ! AreHardwareCountersEnabled() )
+    {
+        return nullptr;
+    }
+    if( ! t_counters_opened ) [[unlikely]]
+    {
+        t_counters = RegisterThreadCounters();
+        t_counters_opened = true;
+    }
+    return t_counters;
+}
+
+inline
+auto Local() -> ThreadMetrics &
+{
+    if( t_local == nullptr ) [[unlikely]]
+    {
+        t_local = RegisterThread();
+    }
+    return *t_local;
+}
+
+/**
+ * Adds to one of the calling thread's counters
+ */
+inline
+void Add( [[maybe_unused]] Counter counter, [[maybe_unused]] std::uint64_t amount = 1 )
+{
+#ifdef KSKYCORE_METRICS
+    Local().counters[ static_cast< std::size_t >( counter ) ] += amount;
+#endif
+}
+
+/**
+ * Adds a duration to one of the calling thread's phases
+ */
+inline
+void AddTime( [[maybe_unused]] Phase phase
+            , [[maybe_unused]] std::chrono::nanoseconds duration
+            , [[maybe_unused]] HardwareCounts const& hardware = {} )
+{
+#ifdef KSKYCORE_METRICS
+    auto & stats = Local().phases[ static_cast< std::size_t >( phase ) ];
+    stats.nanoseconds += duration.count();
+    ++stats.invocations;
+    for( std::size_t i = 0; i < num_hardware_events; ++i )
+    {
+        stats.hardware[ i ] += hardware[ i ];
+    }
+    if constexpr( memory::accounting_enabled )
+    {
+        stats.peak_heap_bytes = std::max( stats.peak_heap_bytes, memory::PeakHeapBytes() );
+        stats.peak_rss_kb = std::max( stats.peak_rss_kb, memory::PeakResidentKilobytes() );
+    }
+#endif
+}
+
+/**
+ * Records in a query's record, if it has one, the sky layer at which it terminated early
+ */
+void RecordTermination( QueryRecord * record, std::int64_t layer );
+
+/**
+ * Records in a query's record, if it has one, the size of the skyline after the scan reached a given vertex
+ */
+void RecordSkylineSize( QueryRecord * record, std::int64_t vertex, std::uint64_t size );
+
+/**
+ * Aggregates the metrics of all threads, together with a query's record if given. Should not be called while a query is running.
+ */
+auto Collect( QueryRecord const* query = nullptr ) -> Report;
+
+/**
+ * Zeroes all metrics and lowers memory high-water marks to current usage.
+ * Should not be called while a query is running.
+ */
+void Reset();
+
+/**
+ * Serialises a report as a JSON object
+ */
+auto ToJson( Report const& report ) -> std::string;
+
+/**
+ * RAII timer that charges its lifetime, and the hardware events counted during it, to a phase on the calling thread
+ */
+class ScopedPhase
+{
+public:
+
+    explicit ScopedPhase( Phase phase )
+#ifdef KSKYCORE_METRICS
+        : m_phase( phase )
+        , m_counters( LocalCounters() )
+#endif
+    {
+        static_cast< void >( phase );
+#ifdef KSKYCORE_METRICS
+        if( m_counters != nullptr )
+        {
+            m_hardware_start = m_counters->Read();
+        }
+        m_start = std::chrono::steady_clock::now();
+#endif
+    }
+
+    ~ScopedPhase()
+    {
+#ifdef KSKYCORE_METRICS
+        auto const duration = std::chrono::steady_clock::now() - m_start;
+        HardwareCounts hardware = {};
+        if( m_counters != nullptr )
+        {
+            hardware = m_counters->Read();
+            for( std::size_t i = 0; i < num_hardware_events; ++i )
+            {
+                hardware[ i ] -= m_hardware_start[ i ];
+            }
+        }
+        AddTime( m_phase, duration, hardware );
+#endif
+    }
+
+    ScopedPhase( ScopedPhase const& ) = delete;
+    ScopedPhase & operator = ( ScopedPhase const& ) = delete;
+
+private:
+
+#ifdef KSKYCORE_METRICS
+    Phase m_phase;
+    PerfCounterGroup const* m_counters;
+    HardwareCounts m_hardware_start = {};
+    std::chrono::steady_clock::time_point m_start;
+#endif
+};
+
+} // namespace metrics
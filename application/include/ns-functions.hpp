@@ -3,18 +3,19 @@
 #include <string>
 
 #include "graph.hpp"
+#include "query-context.hpp"
 
 namespace base
 {   
     namespace sequential
     {
-        auto GetSkylineCommunities( Graph & myGraph, int coreSize, int groupSize ) -> group_list_t;
+        auto GetSkylineCommunities( Graph const& myGraph, int coreSize, int groupSize, QueryContext const& context = {} ) -> group_list_t;
 
-        auto GenerateSummerPlot( Graph & myGraph, int coreSize) -> std::vector<size_t>;
+        auto GenerateSummerPlot( Graph const& myGraph, int coreSize) -> std::vector<size_t>;
         void to_file( const std::vector<size_t>& vector, const std::string filePath);
     }
     namespace parallel
     {
-        auto GetSkylineCommunities( Graph & myGraph, int coreSize, int groupSize, int nThreads ) -> group_list_t;
+        auto GetSkylineCommunities( Graph const& myGraph, int coreSize, int groupSize, int nThreads, QueryContext const& context = {} ) -> group_list_t;
     }
 }
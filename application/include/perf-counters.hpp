@@ -0,0 +1,63 @@
+/**
+ * Hardware performance counters of the calling thread, read through Linux perf_event_open.
+ * On other platforms, or where the kernel denies access, the counters are simply unavailable.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+enum class HardwareEvent
+{
+    cycles,
+    instructions,
+    llc_misses,
+    branch_misses,
+    count_ // number of events; not an event
+};
+
+constexpr std::size_t num_hardware_events = static_cast< std::size_t >( HardwareEvent::count_ );
+
+auto ToString( HardwareEvent event ) -> char const*;
+
+/**
+ * Counter values, indexed by HardwareEvent
+ */
+using HardwareCounts = std::array< std::uint64_t, num_hardware_events >;
+
+/**
+ * A group of hardware counters that only counts events of the thread that opened it,
+ * in user space. Open and read it from the same thread.
+ */
+class PerfCounterGroup
+{
+public:
+
+    PerfCounterGroup();
+    ~PerfCounterGroup();
+
+    PerfCounterGroup( PerfCounterGroup const& ) = delete;
+    PerfCounterGroup & operator = ( PerfCounterGroup const& ) = delete;
+
+    /**
+     * Whether a given event could be opened; its counts are zero otherwise
+     */
+    bool IsAvailable( HardwareEvent event ) const { return m_fds[ static_cast< std::size_t >( event ) ] >= 0; }
+
+    /**
+     * Whether any event could be opened at all
+     */
+    bool IsAvailable() const { return m_leader >= 0; }
+
+    /**
+     * Returns the current (monotonically increasing) count of every event,
+     * scaled up if the kernel had to multiplex the counters
+     */
+    auto Read() const -> HardwareCounts;
+
+private:
+
+    std::array< int, num_hardware_events > m_fds;
+    int m_leader = -1;
+};
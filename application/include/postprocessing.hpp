@@ -1,6 +1,42 @@
 #pragma once
 
+#include <algorithm>
+#include <vector>
+
 #include "dominance-tests.hpp"
+#include "group-store.hpp"
+#include "query-context.hpp"
+
+/**
+ * Whether postprocess would remove the group at curr, i.e., whether it is dominated by one of the
+ * groups that follow it and whose first members have the same label as its first member.
+ * Pointer next iterates through all groups that might dominate it. Dereferencing an iterator
+ * may yield a group by reference or a view of it (as for a GroupStore).
+ */
+template < typename ForwardIterator, typename PointList >
+bool IsFalsePositive( ForwardIterator curr, ForwardIterator last, PointList const& labels )
+{
+    auto const& curr_group = *curr; // a reference, or a view that lives as long as the reference
+    for( ForwardIterator next = curr + 1; next != last; ++next )
+    {
+        auto const& next_group = *next;
+        int const next_first_node_id = *std::cbegin( next_group );
+        int const curr_first_node_id = *std::cbegin( curr_group );
+        auto const dt_result = PointDominanceTest( labels[ next_first_node_id ].cbegin()
+                                                 , labels[ next_first_node_id ].cend()
+                                                 , labels[ curr_first_node_id ].cbegin() );
+
+        if( dt_result != DominanceTestResult::equal )
+        {
+            return false;
+        }
+        else if( GroupDominanceTest( std::cbegin( next_group ), std::cend( next_group ), std::cbegin( curr_group ), std::cend( curr_group ), labels ) )
+        {
+            return true;
+        }
+    }
+    return false;
+}
 
 /**
  * Postprocesses a skyline result to remove false positives by copying over top of them
@@ -16,44 +52,16 @@
 template < typename ForwardIterator, typename PointList >
 ForwardIterator postprocess( ForwardIterator first, ForwardIterator last, PointList const& labels )
 {
-    // Three pointer algorithm. Pointer first indicates the end of the range
+    // Two pointer algorithm. Pointer first indicates the end of the range
     // of already confirmed values, i.e., the destination to which should be writen
     // newly confirmed groups.
     // Pointer curr indicates the the group currently being processed, i.e., the next
-    // one after start that could appear in the solution
-    // Finally, pointer next indicates the next group to compare against curr in order
-    // to validate it.
+    // one after start that could appear in the solution.
     // Algorithm moves curr from first to last to process all input groups, copying to
-    // start++ those that are not dominated. For each group that is processed, pointer
-    // next iterates through all groups that might dominate it.
+    // start++ those that are not dominated.
     for( ForwardIterator curr = first; curr != last; ++curr )
     {
-        ForwardIterator next = curr + 1;
-        bool isSkyline = true;
-
-        while( next != last )
-        {
-            int const next_first_node_id = *( next->cbegin() );
-            int const curr_first_node_id = *( curr->cbegin() );
-            auto const dt_result = PointDominanceTest( labels[ next_first_node_id ].cbegin()
-                                                     , labels[ next_first_node_id ].cend()
-                                                     , labels[ curr_first_node_id ].cbegin() );
-
-            if( dt_result != DominanceTestResult::equal )
-            {
-                break;
-            }
-            else if( GroupDominanceTest( next->cbegin(), next->cend(), curr->cbegin(), curr->cend(), labels ) )
-            {
-                isSkyline = false;
-                break;
-            }
-            else
-            {
-                ++next;
-            }
-        }
-        if( isSkyline )
+        if( ! IsFalsePositive( curr, last, labels ) )
         {
             if( first != curr ) // skip unnecessary copy if source == destination
             {
@@ -65,3 +73,108 @@ ForwardIterator postprocess( ForwardIterator first, ForwardIterator last, PointL
 
     return first;
 }
+
+/**
+ * Postprocesses a skyline held in a GroupStore; see above
+ */
+template < typename PointList >
+void postprocess( GroupStore & groups, PointList const& labels )
+{
+    std::vector< bool > keep( groups.size() );
+    for( auto curr = std::cbegin( groups ); curr != std::cend( groups ); ++curr )
+    {
+        keep[ curr.GetIndex() ] = ! IsFalsePositive( curr, std::cend( groups ), labels );
+    }
+    groups.Compact( keep );
+}
+
+/**
+ * Start of the trailing run of groups in [first, last) whose first members have equal labels: while a skyline
+ * is still being appended to, these are the only groups that a later group could show to be false positives.
+ */
+template < typename RandomIterator, typename PointList >
+RandomIterator FindUnsettledGroups( RandomIterator first, RandomIterator last, PointList const& labels )
+{
+    RandomIterator stop = last;
+    if( first != last )
+    {
+        auto const FirstLabel = [ &labels ]( RandomIterator const it ) -> auto const& { return labels[ *std::cbegin( *it ) ]; };
+        auto const& last_label = FirstLabel( last - 1 );
+        do
+        {
+            --stop;
+        }
+        while( stop != first && PointDominanceTest( FirstLabel( stop - 1 ).cbegin()
+                                                  , FirstLabel( stop - 1 ).cend()
+                                                  , last_label.cbegin() ) == DominanceTestResult::equal );
+    }
+    return stop;
+}
+
+/**
+ * Streaming counterpart of postprocess for a skyline that is still being appended to: passes to emit,
+ * in order, the groups in [first, last) that postprocess will keep and whose fate can no longer change,
+ * i.e., all but the trailing run of groups whose first members have equal labels, or all of them if
+ * the skyline is complete. Leaves the range unchanged and returns where to resume once more groups are appended.
+ *
+ * @pre Same as postprocess
+ */
+template < typename RandomIterator, typename PointList, typename Emit >
+RandomIterator EmitFinalGroups( RandomIterator first, RandomIterator last, PointList const& labels, Emit && emit, bool is_complete )
+{
+    RandomIterator const stop = is_complete ? last : FindUnsettledGroups( first, last, labels );
+    for( RandomIterator curr = first; curr != stop; ++curr )
+    {
+        if( ! IsFalsePositive( curr, last, labels ) )
+        {
+            emit( *curr );
+        }
+    }
+    return stop;
+}
+
+/**
+ * Counterpart of postprocess for a skyline whose scan stopped early, at position frontier of the vertex order, because
+ * the query ran out of budget: keeps only the groups that are final, streams those from position emitted onwards to
+ * the context's sink, if any, and records in the context's progress how far the result is complete. Unsettled groups
+ * remain so only if the frontier has the label of their first members; as groups are appended in order of their
+ * first members, they then move the frontier back to the first of those.
+ *
+ * @pre Same as postprocess
+ */
+template < typename PointList >
+void FinishPartialSkyline( GroupStore & groups, std::size_t const emitted, PointList const& labels, int frontier, QueryContext const& context )
+{
+    auto stop = FindUnsettledGroups( std::cbegin( groups ) + emitted, std::cend( groups ), labels );
+    if( stop != std::cend( groups ) )
+    {
+        auto const& first_label = labels[ *std::cbegin( *stop ) ];
+        if( PointDominanceTest( first_label.cbegin(), first_label.cend(), labels[ frontier ].cbegin() ) == DominanceTestResult::equal )
+        {
+            frontier = *std::cbegin( *stop );
+        }
+        else
+        {
+            stop = std::cend( groups );
+        }
+    }
+    if( context.progress != nullptr )
+    {
+        context.progress->complete = false;
+        context.progress->scanned = frontier;
+    }
+
+    std::vector< bool > keep( groups.size(), false );
+    for( auto curr = std::cbegin( groups ) + emitted; curr != stop; ++curr )
+    {
+        if( ! IsFalsePositive( curr, std::cend( groups ), labels ) )
+        {
+            keep[ curr.GetIndex() ] = true;
+            if( context.sink != nullptr )
+            {
+                context.sink->Write( *curr );
+            }
+        }
+    }
+    groups.Compact( keep );
+}
@@ -0,0 +1,107 @@
+/**
+ * Per-query state that is shared between a running engine and its caller,
+ * such as cooperative cancellation.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace metrics
+{
+struct QueryRecord;
+}
+
+/**
+ * A flag that the caller of a query may raise at any time to ask the engine to stop.
+ * Engines poll it between vertices, so cancellation takes effect within the time
+ * needed to process one neighbourhood.
+ */
+class CancellationToken
+{
+public:
+
+    void Cancel() { m_cancelled.store( true, std::memory_order_relaxed ); }
+
+    bool IsCancelled() const { return m_cancelled.load( std::memory_order_relaxed ); }
+
+private:
+
+    std::atomic< bool > m_cancelled = false;
+};
+
+/**
+ * Thrown by the query interface when a query was stopped through its CancellationToken
+ */
+struct QueryCancelled : std::runtime_error
+{
+    QueryCancelled() : std::runtime_error( "query cancelled" ) {}
+};
+
+/**
+ * Receives the groups of a skyline incrementally, as soon as an engine knows that they are final,
+ * so that large skylines can be written out without materialising the result. Groups are in the
+ * engine's internal vertex ids (see ResultWriter for mapping them back). Never called concurrently.
+ */
+class GroupSink
+{
+public:
+
+    virtual ~GroupSink() = default;
+
+    virtual void Write( std::span< int const > group ) = 0;
+};
+
+/**
+ * Limits on the wall-clock time and the work that a query may spend. A query that exhausts its budget stops
+ * scanning and returns, or finishes streaming, the part of its skyline that is already final (see QueryProgress).
+ * Work is counted in vertices of the scan order, which every engine passes through in the same order.
+ */
+struct QueryBudget
+{
+    std::optional< std::chrono::steady_clock::time_point > deadline;
+    std::optional< int > max_scanned;
+
+    bool IsExhausted( int const num_scanned ) const
+    {
+        return ( max_scanned && num_scanned >= *max_scanned )
+            || ( deadline && std::chrono::steady_clock::now() >= *deadline );
+    }
+};
+
+/**
+ * How far the scan of a query reached, so that the guarantee of a partial skyline is explicit: every skyline group
+ * with a member among the first `scanned` vertices of the scan order is reported, and so is every skyline group
+ * with a member in one of the first `layers_completed` sky layers. Each reported group is in the full skyline.
+ */
+struct QueryProgress
+{
+    bool complete = true;          // false if the budget ran out before the scan did
+    int scanned = 0;               // vertices of the scan order whose groups have all been reported
+    int frontier = -1;             // the first vertex that has not, in the ids of the input files; -1 if complete
+    int layers_completed = 0;
+    int num_layers = 0;
+};
+
+/**
+ * Optional hooks through which the caller of an engine can observe and steer a query.
+ * A default-constructed context imposes nothing.
+ */
+struct QueryContext
+{
+    CancellationToken const* cancellation = nullptr;
+    GroupSink * sink = nullptr;
+    std::span< char const > admitted = {}; // if not empty, a flag per vertex (in engine ids) of whether groups may contain it
+    QueryBudget budget = {};
+    QueryProgress * progress = nullptr;
+    metrics::QueryRecord * record = nullptr; // receives the termination layer and skyline sizes, if metrics are compiled in
+
+    bool IsCancelled() const { return cancellation != nullptr && cancellation->IsCancelled(); }
+    bool IsOverBudget( int const num_scanned ) const { return budget.IsExhausted( num_scanned ); }
+    bool IsAdmitted( int const vertex ) const { return admitted.empty() || admitted[ vertex ]; }
+};
@@ -0,0 +1,69 @@
+/**
+ * Output stage for skyline groups: maps each group back to the vertex ids of the input files,
+ * optionally attaches its best and worst virtual points, and appends it to a buffered stream.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+#include "graph.hpp"
+#include "query-context.hpp"
+
+namespace base
+{
+
+/**
+ * Formats of a written skyline:
+ *   - csv: one line per group, the ids of its members followed, if labels are attached,
+ *     by the coordinates of its best and then of its worst virtual point
+ *   - binary: a little-endian 64-bit header holding the dimension of attached labels (0 if none),
+ *     then per group its size as 32-bit integer followed by the same fields as in csv, as 32-bit integers
+ */
+enum class ResultFormat
+{
+    csv,
+    binary
+};
+
+/**
+ * A sink that writes groups as they arrive, so it can be passed in a QueryContext to stream a skyline
+ * straight to the stream, or fed the groups of a completed query through Write().
+ * Not thread-safe; engines never call a sink concurrently.
+ */
+class ResultWriter : public GroupSink
+{
+public:
+
+    /**
+     * @param graph the preprocessed graph that the groups refer to, in its internal ids
+     */
+    ResultWriter( std::ostream & out, Graph const& graph, ResultFormat format, bool attachLabels = false );
+
+    ~ResultWriter() override;
+
+    void Write( std::span< vertex_id_t const > group ) override;
+
+    /**
+     * Writes out buffered groups
+     */
+    void Flush();
+
+    auto GetNumGroups() const -> std::uint64_t { return m_num_groups; }
+
+    ResultWriter( ResultWriter const& ) = delete;
+    ResultWriter & operator = ( ResultWriter const& ) = delete;
+
+private:
+
+    std::ostream & m_out;
+    Graph const& m_graph;
+    ResultFormat m_format;
+    bool m_attach_labels;
+    std::string m_buffer;
+    std::uint64_t m_num_groups = 0;
+};
+
+} // namespace base
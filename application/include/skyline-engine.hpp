@@ -0,0 +1,157 @@
+/**
+ * Reusable query interface around the skyline community engines, for embedding in
+ * long-running processes that answer many queries against one loaded graph.
+ */
+
+#pragma once
+
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "graph.hpp"
+#include "query-context.hpp"
+
+namespace base
+{
+
+enum class Algorithm
+{
+    skcore = 0,
+    pkcore = 1,
+    baseline = 2
+};
+
+/**
+ * A predicate that admits the vertices whose coordinate in one dimension lies in [lower, upper]
+ */
+struct LabelRange
+{
+    dimension_t dimension = 0;
+    coordinate_t lower = std::numeric_limits< coordinate_t >::lowest();
+    coordinate_t upper = std::numeric_limits< coordinate_t >::max();
+};
+
+/**
+ * Restricts a query to the groups whose members all satisfy every label range and, if given,
+ * belong to a subset of vertices named by their ids in the input files. Applied at query time by
+ * deactivating the other vertices before the initial peel, so the graph need not be reloaded.
+ */
+struct VertexFilter
+{
+    std::vector< LabelRange > ranges;
+    std::optional< vertex_list_t > vertices;
+
+    bool IsEmpty() const { return ranges.empty() && ! vertices.has_value(); }
+};
+
+/**
+ * Parameters of a single skyline community query. The k and g values follow the
+ * command-line convention, i.e., k is the clique relaxation and g the group size.
+ */
+struct SkylineQuery
+{
+    int kPlexSize = 0;
+    int groupSize = 0;
+    Algorithm algorithm = Algorithm::pkcore;
+    int nThreads = 1;
+    VertexFilter filter = {};
+    std::vector< dimension_t > dimensions = {}; // if given, the subspace of label dimensions to query (see GetSubspace)
+
+    auto GetCoreSize() const -> int { return groupSize - kPlexSize - 1; }
+};
+
+/**
+ * Owns a preprocessed graph and answers skyline community queries against it.
+ * Queries never modify the graph: each one peels its own working copy of the adjacency
+ * lists, so the same engine can be queried repeatedly and from several threads at once.
+ * Results are reported in the vertex ids of the input files, i.e., mapped through toOriginal.
+ */
+class SkylineEngine
+{
+public:
+
+    /**
+     * Takes ownership of a graph with edges and labels as loaded from file and
+     * preprocesses it, i.e., relabels vertices and computes sky layers.
+     */
+    explicit SkylineEngine( Graph graph );
+
+    /**
+     * Loads and preprocesses a graph from an edge file and a label file (see LoadGraph).
+     * @throws std::runtime_error if either file cannot be read or they do not match
+     */
+    static auto FromFiles( std::string const& edgesFilePath
+                         , std::string const& labelsFilePath
+                         , std::optional< vertex_id_t > nodeSize = std::nullopt ) -> SkylineEngine;
+
+    /**
+     * Computes the skyline communities for the given query. If the context has a sink, groups are
+     * passed to it as they become final instead, and an empty list is returned. The label ranges
+     * of a filter refer to the dimensions of the queried subspace, if the query names one. If the context's
+     * budget runs out, only the groups that are already final are returned, or streamed, and the context's
+     * progress says which of the skyline they include.
+     * @throws std::invalid_argument if k and g are inconsistent or unsupported by the algorithm
+     * @throws QueryCancelled if the context's cancellation token is raised before the query completes
+     */
+    auto Query( SkylineQuery const& query, QueryContext const& context = {} ) const -> group_list_t;
+
+    /**
+     * Creates a new engine over the same graph in which every label is projected onto the
+     * given dimensions (in the given order). Requires a full preprocessing pass of its own.
+     * @throws std::invalid_argument if a dimension is out of range or no dimension is given
+     */
+    auto Subspace( std::vector< dimension_t > const& dimensions ) const -> SkylineEngine;
+
+    /**
+     * Returns the engine of a subspace as Subspace does, but preprocesses each subspace only on first use
+     * and keeps it, so that repeated queries of a subspace share one preprocessing pass. Queries with
+     * dimensions are answered through it. Each cached engine holds its own copy of the adjacency lists
+     * besides its projected labels and sky layers, i.e., about as much memory as this engine, so only the
+     * max_cached_subspaces most recently used subspaces are kept.
+     * @throws std::invalid_argument if a dimension is out of range or no dimension is given
+     */
+    auto GetSubspace( std::vector< dimension_t > const& dimensions ) const -> std::shared_ptr< SkylineEngine const >;
+
+    static constexpr std::size_t max_cached_subspaces = 4;
+
+    /**
+     * Returns the preprocessed graph, i.e., with relabelled vertex ids.
+     */
+    auto GetGraph() const -> Graph const& { return myGraph; }
+
+private:
+
+    class SubspaceCache;
+
+    Graph myGraph;
+    std::shared_ptr< SubspaceCache > m_subspaces;
+};
+
+/**
+ * Validates that a query can be answered, returning an empty string on success
+ * or a human-readable reason otherwise.
+ */
+auto ValidateQuery( SkylineQuery const& query ) -> std::string;
+
+/**
+ * Flags, per relabelled vertex id, whether a vertex passes the filter.
+ * @throws std::invalid_argument if a dimension or vertex id is out of range
+ */
+auto GetAdmittedVertices( VertexFilter const& filter, Graph const& myGraph ) -> std::vector< char >;
+
+/**
+ * Parses a label range written as <dimension>:<lower>:<upper>, either bound of which may be left empty
+ * to leave it open, e.g., "2::500" for coordinates of at most 500 in dimension 2.
+ * @throws std::invalid_argument if the text is malformed
+ */
+auto ParseLabelRange( std::string const& text ) -> LabelRange;
+
+/**
+ * Maps each group from relabelled vertex ids back to the ids of the input files.
+ */
+auto ToOriginalIds( group_list_t groups, Graph const& myGraph ) -> group_list_t;
+
+} // namespace base
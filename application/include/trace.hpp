@@ -0,0 +1,106 @@
+/**
+ * Opt-in per-thread timeline tracing that is written out in the Chrome/Perfetto trace event format.
+ * Compiled to no-ops unless KSKYCORE_TRACING is defined; otherwise spans are only recorded
+ * while tracing is switched on at runtime with SetEnabled( true ).
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace trace
+{
+
+/**
+ * A completed span on one thread, optionally annotated with the vertex being processed
+ * and the size of its neighbourhood (-1 if not applicable)
+ */
+struct Span
+{
+    char const* name;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::time_point end;
+    std::int64_t vertex;
+    std::int64_t size;
+};
+
+void SetEnabled( bool enabled );
+bool IsEnabled();
+
+/**
+ * Returns the calling thread's span buffer, registering it on first use
+ */
+auto RegisterThread() -> std::vector< Span > *;
+
+inline thread_local std::vector< Span > * t_spans = nullptr;
+
+/**
+ * Discards all recorded spans
+ */
+void Clear();
+
+/**
+ * Writes all recorded spans as a Chrome trace JSON document, one track per thread
+ */
+void WriteChromeTrace( std::ostream & out );
+
+/**
+ * RAII span covering its own lifetime on the calling thread
+ */
+class ScopedSpan
+{
+public:
+
+    explicit ScopedSpan( [[maybe_unused]] char const* name
+                       , [[maybe_unused]] std::int64_t vertex = -1
+                       , [[maybe_unused]] std::int64_t size = -1 )
+    {
+#ifdef KSKYCORE_TRACING
+        if( IsEnabled() )
+        {
+            m_span = Span{ name, std::chrono::steady_clock::now(), {}, vertex, size };
+            m_active = true;
+        }
+#endif
+    }
+
+    ~ScopedSpan()
+    {
+#ifdef KSKYCORE_TRACING
+        if( m_active )
+        {
+            if( t_spans == nullptr ) [[unlikely]]
+            {
+                t_spans = RegisterThread();
+            }
+            m_span.end = std::chrono::steady_clock::now();
+            t_spans->push_back( m_span );
+        }
+#endif
+    }
+
+    /**
+     * Annotates the span with a size that only becomes known after it has started
+     */
+    void SetSize( [[maybe_unused]] std::int64_t size )
+    {
+#ifdef KSKYCORE_TRACING
+        m_span.size = size;
+#endif
+    }
+
+    ScopedSpan( ScopedSpan const& ) = delete;
+    ScopedSpan & operator = ( ScopedSpan const& ) = delete;
+
+private:
+
+#ifdef KSKYCORE_TRACING
+    Span m_span{};
+    bool m_active = false;
+#endif
+};
+
+} // namespace trace
@@ -1,15 +1,16 @@
 #pragma once
 
 #include "graph.hpp"
+#include "query-context.hpp"
 
 namespace base
 {
     namespace zhang
     {
-        void GetSkylineCommunities(Graph& myGraph, int coreSize, int groupSize, group_list_t& skylineCommunities);
+        void GetSkylineCommunities(Graph const& myGraph, int coreSize, int groupSize, group_list_t& skylineCommunities, QueryContext const& context = {});
     }
     namespace zhangBaseline
     {
-        void GetSkylineCommunities(Graph& myGraph, int coreSize, int groupSize, group_list_t & skylineCommunities);
+        void GetSkylineCommunities(Graph const& myGraph, int coreSize, int groupSize, group_list_t & skylineCommunities);
     }
 }
@@ -21,16 +21,6 @@ int main (int argc, char** argv)
     vertex_degree_t group_size;
     vertex_degree_t min_coreness;
 
-    // HACK ALERT!!!! 🙈🙈🙈🙈🙈🙈
-    // these values should be read from the input file, not stored in a map 🙈🙈🙈🙈🙈🙈
-    std::unordered_map< std::string, vertex_degree_t > node_counts = {{ "../../../Data/Datasets/Casestudy/case_study_edges.csv",                5856 }
-                                                                    , { "../../../Data/Datasets/Youtube/com-youtube.ungraph_undirected.csv", 1157828 }
-                                                                    , { "../../../Data/Datasets/LiveJournal/LiveJournal_undirected.csv",     4847571 }
-                                                                    , { "../../../Data/Datasets/DBLP/dblp_undirected.csv",                   425957 }
-                                                                    , { "../../../Data/Datasets/Amazon/amazon_undirected.csv",               735324 }
-                                                                    , { "../../../Data/Datasets/WikiTalk/wiki_talk_undirected.csv",          2394385 }
-                                                                    , { "../../../Data/Datasets/CitPatent/cit_patents_undirected.csv",       6009555 } };
- 
     try
     {
         namespace po = boost::program_options;
@@ -38,10 +28,10 @@ int main (int argc, char** argv)
         po::options_description desc("Execution arguments for comparing size-g k-core listing algorithms");
         desc.add_options()
             (ARG_HELP, "show usage instructions")
-            (ARG_ALGORITHM, po::value<std::string>( &algorithms )->required(), "space-delimited list of algorithm; choices are: {cousins-first}")
+            (ARG_ALGORITHM, po::value<std::string>( &algorithms )->required(), "space-delimited list of algorithm; choices are: {cousins-first, cousins-first-size}")
             (ARG_DEGREE,    po::value<vertex_degree_t>( &min_coreness )->required(), "minimum degree in result sub-graph, i.e., subgraph coreness")
             (ARG_GROUP,     po::value<vertex_degree_t>( &group_size )->required(), "number of vertices in each group")
-            (ARG_INPUT,     po::value<std::string>( &input_file )->required(), "path to file with edge list")
+            (ARG_INPUT,     po::value<std::string>( &input_file )->required(), "path to file with edge list, CSV or binary (.bin)")
             ;
 
         po::variables_map vm;
@@ -78,13 +68,6 @@ int main (int argc, char** argv)
             return 0;
         }
 
-        if( node_counts.count( input_file ) < 1 )
-        {
-            std::cout << "I have never seen this file path before. Sorry." << std::endl;
-            std::cout << desc << std::endl;
-            return 0;
-        }
-
         std::cout << "Input: " << input_file << std::endl;
         std::cout << "Group size: " << group_size << std::endl;
         std::cout << "Minimum coreness: " << min_coreness << std::endl;
@@ -94,7 +77,7 @@ int main (int argc, char** argv)
         Graph input_graph;
         {
             Time time("Preprocessing Time: ");
-            if( LoadEdges( input_file, input_graph.edges, node_counts[ input_file ] ) )
+            if( LoadEdges( input_file, input_graph.edges ) )
             {
                 input_graph.size = input_graph.edges.size();
 
@@ -107,7 +90,6 @@ int main (int argc, char** argv)
             else
             {
                 std::cerr << "Error loading input file: " << input_file << std::endl;
-                std::cerr << "If it is relevant, we expected " << node_counts[ input_file ] << " contiguous vertex ids." << std::endl;
                 return -1;
             }
         }
@@ -123,6 +105,14 @@ int main (int argc, char** argv)
                 auto const all_kcores = base::listing::cousins_first::ListAllKCores( input_graph.edges, group_size, min_coreness );
                 std::cout << "  #k-cores: " <<  all_kcores.size() <<"\n";
             }
+            else if( next_algorithm.compare( "cousins-first-size" ) == 0 )
+            {
+                // as above, but cutting branches only by the size of their tailsets, as before colouring bounds
+                Time time("Cousins-first (tailset size bound) Listing Time: ");
+                auto const all_kcores = base::listing::cousins_first::ListAllKCores( input_graph.edges, group_size, min_coreness
+                                                                                   , base::listing::cousins_first::Bound::tailset_size );
+                std::cout << "  #k-cores: " <<  all_kcores.size() <<"\n";
+            }
             else 
             {
                 std::cout << "Unrecognised algorithm: " << next_algorithm
@@ -0,0 +1,158 @@
+/**
+ * Writes a synthetic graph and/or synthetic vertex labels in the formats read by LoadEdges and LoadLabels
+ */
+
+#include <boost/program_options.hpp> // for handling input arguments
+#include <iostream>
+#include <omp.h>
+
+#include "generators.hpp"
+#include "timer.hpp"
+
+namespace { // anonymous
+
+const char* ARG_HELP        = "help,h";
+const char* ARG_VERTICES    = "vertices,n";
+const char* ARG_SEED        = "seed,s";
+const char* ARG_THREADS     = "threads,t";
+const char* ARG_GRAPH       = "graph";
+const char* ARG_DEGREE      = "average-degree";
+const char* ARG_EXPONENT    = "exponent";
+const char* ARG_COMMUNITIES = "communities";
+const char* ARG_MIXING      = "mixing";
+const char* ARG_EDGES_OUT   = "edges-out,e";
+const char* ARG_LABELS      = "labels";
+const char* ARG_DIMENSION   = "dimension,d";
+const char* ARG_LOW         = "low";
+const char* ARG_HIGH        = "high";
+const char* ARG_LABELS_OUT  = "labels-out,o";
+
+} // namespace anonymous
+
+int main (int argc, char** argv)
+{
+    vertex_id_t   num_vertices;
+    std::uint64_t seed;
+    int           num_threads;
+    std::string   graph_model;
+    double        average_degree;
+    double        exponent;
+    vertex_id_t   num_communities;
+    double        mixing;
+    std::string   edges_file;
+    std::string   label_model;
+    dimension_t   dimension;
+    coordinate_t  low;
+    coordinate_t  high;
+    std::string   labels_file;
+
+    try
+    {
+        namespace po = boost::program_options;
+
+        po::options_description desc("Execution arguments for generating synthetic graphs and labels");
+        desc.add_options()
+            (ARG_HELP, "show usage instructions")
+            (ARG_VERTICES,    po::value< vertex_id_t >( &num_vertices )->required(), "number of vertices")
+            (ARG_SEED,        po::value< std::uint64_t >( &seed )->default_value( 2030 ), "seed; output is identical for any number of threads")
+            (ARG_THREADS,     po::value< int >( &num_threads )->default_value( omp_get_max_threads() ), "number of threads")
+            (ARG_GRAPH,       po::value< std::string >( &graph_model ), "graph model; choices are: {rmat, chung-lu, planted}")
+            (ARG_DEGREE,      po::value< double >( &average_degree )->default_value( 16 ), "average degree (before removing duplicate edges)")
+            (ARG_EXPONENT,    po::value< double >( &exponent )->default_value( 2.5 ), "power-law exponent of chung-lu degrees")
+            (ARG_COMMUNITIES, po::value< vertex_id_t >( &num_communities )->default_value( 1000 ), "number of planted communities")
+            (ARG_MIXING,      po::value< double >( &mixing )->default_value( 0.1 ), "fraction of planted edges that cross communities")
+            (ARG_EDGES_OUT,   po::value< std::string >( &edges_file ), "file to write the edges to")
+            (ARG_LABELS,      po::value< std::string >( &label_model ), "label distribution; choices are: {indep, corr, anticorr}")
+            (ARG_DIMENSION,   po::value< dimension_t >( &dimension )->default_value( 2 ), "number of label dimensions")
+            (ARG_LOW,         po::value< coordinate_t >( &low )->default_value( 0 ), "smallest coordinate")
+            (ARG_HIGH,        po::value< coordinate_t >( &high )->default_value( 100 ), "upper bound on coordinates")
+            (ARG_LABELS_OUT,  po::value< std::string >( &labels_file ), "file to write the labels to")
+            ;
+
+        po::variables_map vm;
+        po::store( po::parse_command_line( argc, argv, desc ), vm );
+
+        // If someone needs help, nothing else matters.
+        if ( vm.count("help") || argc == 1 )
+        {
+            std::cout << desc << std::endl;
+            return 0;
+        }
+        po::notify( vm );
+
+        if( graph_model.empty() != edges_file.empty() || label_model.empty() != labels_file.empty() )
+        {
+            throw std::invalid_argument( "--graph and --edges-out, and --labels and --labels-out, must be given together" );
+        }
+        if( graph_model.empty() && label_model.empty() )
+        {
+            throw std::invalid_argument( "nothing to generate; give --graph and/or --labels" );
+        }
+        omp_set_num_threads( num_threads );
+
+        if( ! graph_model.empty() )
+        {
+            generators::edge_list_t edges;
+            {
+                Time time( "Graph generation time" );
+                if( graph_model == "rmat" )
+                {
+                    edges = generators::GenerateRmat( num_vertices, average_degree, {}, seed );
+                }
+                else if( graph_model == "chung-lu" )
+                {
+                    edges = generators::GenerateChungLu( num_vertices, average_degree, exponent, seed );
+                }
+                else if( graph_model == "planted" )
+                {
+                    edges = generators::GeneratePlantedCommunities( num_vertices, average_degree, num_communities, mixing, seed );
+                }
+                else
+                {
+                    throw std::invalid_argument( "unknown graph model " + graph_model );
+                }
+            }
+            if( ! generators::WriteEdges( edges_file, edges ) )
+            {
+                throw std::runtime_error( "could not write " + edges_file );
+            }
+            std::cout << "Wrote " << edges.size() << " edges on " << num_vertices << " vertices to " << edges_file << std::endl;
+        }
+
+        if( ! label_model.empty() )
+        {
+            label_list_t labels;
+            {
+                Time time( "Label generation time" );
+                if( label_model == "indep" )
+                {
+                    labels = generators::GenerateIndependentLabels( num_vertices, dimension, seed, low, high );
+                }
+                else if( label_model == "corr" )
+                {
+                    labels = generators::GenerateCorrelatedLabels( num_vertices, dimension, seed, low, high );
+                }
+                else if( label_model == "anticorr" )
+                {
+                    labels = generators::GenerateAnticorrelatedLabels( num_vertices, dimension, seed, low, high );
+                }
+                else
+                {
+                    throw std::invalid_argument( "unknown label distribution " + label_model );
+                }
+            }
+            if( ! generators::WriteLabels( labels_file, labels ) )
+            {
+                throw std::runtime_error( "could not write " + labels_file );
+            }
+            std::cout << "Wrote " << dimension << "-d labels of " << num_vertices << " vertices to " << labels_file << std::endl;
+        }
+    }
+    catch( std::exception const& e )
+    {
+        std::cerr << "error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
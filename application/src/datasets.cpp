@@ -0,0 +1,39 @@
+#include "datasets.hpp"
+
+auto GetDataset( int const id ) -> std::optional< Dataset >
+{
+    switch( id )
+    {
+        case 4:  return Dataset{ "YouTube",     "com-youtube.ungraph_undirected.csv", 1157828 };
+        case 5:  return Dataset{ "Casestudy",   "case_study_edges.csv",               5856    };
+        case 10: return Dataset{ "LiveJournal", "LiveJournal_undirected.csv",         4847571 };
+        case 11: return Dataset{ "DBLP",        "dblp_undirected.csv",                425957  };
+        case 12: return Dataset{ "Amazon",      "amazon_undirected.csv",              735324  };
+        case 13: return Dataset{ "WikiTalk",    "wiki_talk_undirected.csv",           2394385 };
+        case 14: return Dataset{ "CitPatent",   "cit_patents_undirected.csv",         6009555 };
+        default: return std::nullopt;
+    }
+}
+
+auto ToString( LabelType const labelType ) -> char const*
+{
+    switch( labelType )
+    {
+        case LabelType::independent:    return "independent";
+        case LabelType::correlated:     return "correlated";
+        case LabelType::anticorrelated: return "anti-correlated";
+    }
+    return "unknown";
+}
+
+auto GetLabelsFile( LabelType const labelType, dimension_t const dimension ) -> std::string
+{
+    std::string prefix;
+    switch( labelType )
+    {
+        case LabelType::independent:    prefix = "indep-";          break;
+        case LabelType::correlated:     prefix = "corr-scale=0.5-"; break;
+        case LabelType::anticorrelated: prefix = "anticorr-";       break;
+    }
+    return prefix + std::to_string( dimension ) + "d.csv";
+}
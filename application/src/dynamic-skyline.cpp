@@ -0,0 +1,639 @@
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+#include "dominance-tests.hpp"
+#include "graph-structural-operations.hpp"
+#include "intersection.hpp"
+#include "ns-functions.hpp"
+
+#include "dynamic-skyline.hpp"
+
+namespace { // anonymous
+
+/**
+ * A batch of label updates that moves vertices across more than this fraction of the order in total is
+ * handled by preprocessing the graph afresh, since each move renumbers every vertex that it passes
+ */
+constexpr std::size_t max_shift_divisor = 16;
+
+} // namespace anonymous
+
+
+namespace base
+{
+
+DynamicSkyline::DynamicSkyline( SkylineEngine const& engine, SkylineQuery query )
+    : m_graph( query.dimensions.empty() ? engine.GetGraph() : engine.GetSubspace( query.dimensions )->GetGraph() )
+    , m_query( std::move( query ) )
+{
+    if( auto const reason = ValidateQuery( m_query ); ! reason.empty() )
+    {
+        throw std::invalid_argument( reason );
+    }
+    if( m_query.algorithm == Algorithm::baseline )
+    {
+        throw std::invalid_argument( "dynamic skylines are only maintained with skcore and pkcore" );
+    }
+    m_query.dimensions.clear(); // the graph already is the subspace's
+    if( ! m_query.filter.IsEmpty() )
+    {
+        m_filter = GetAdmittedVertices( m_query.filter, m_graph );
+    }
+
+    InitialiseCore();
+    m_skyline = Compute( m_filter );
+}
+
+auto DynamicSkyline::ApplyEdgeUpdates( EdgeBatch const& batch ) -> SkylineDelta
+{
+    // groups can only break where an edge between two core vertices is deleted
+    std::vector< edge_t > deleted;
+    for( auto const& [ u, v ] : batch.deletions )
+    {
+        vertex_id_t const first = ToRelabelled( u );
+        vertex_id_t const second = ToRelabelled( v );
+        bool const in_core = m_in_core[ first ] && m_in_core[ second ];
+        if( DeleteEdge( first, second ) && in_core )
+        {
+            deleted.push_back( std::minmax( first, second ) );
+        }
+    }
+    std::vector< edge_t > inserted;
+    for( auto const& [ u, v ] : batch.insertions )
+    {
+        vertex_id_t const first = ToRelabelled( u );
+        vertex_id_t const second = ToRelabelled( v );
+        if( InsertEdge( first, second ) )
+        {
+            inserted.emplace_back( first, second );
+        }
+    }
+
+    // evict the skyline groups that lost an edge and with it their minimum degree
+    std::vector< bool > keep( m_skyline.size(), true );
+    std::vector< std::size_t > evicted;
+    for( std::size_t i = 0; i < m_skyline.size() && ! deleted.empty(); ++i )
+    {
+        vertex_list_t const group( std::cbegin( m_skyline[ i ] ), std::cend( m_skyline[ i ] ) );
+        bool const lost_edge = std::ranges::any_of( deleted, [ &group ]( edge_t const& edge )
+        {
+            return std::ranges::binary_search( group, edge.first ) && std::ranges::binary_search( group, edge.second );
+        } );
+        if( lost_edge && ! IsKCore( group, m_graph.edges, m_query.GetCoreSize() ) )
+        {
+            keep[ i ] = false;
+            evicted.push_back( i );
+        }
+    }
+
+    // admit the vertices of every group that could newly enter the skyline
+    std::vector< char > admitted( m_graph.size, 0 );
+    std::size_t num_admitted = 0;
+    auto const Admit = [ & ]( vertex_id_t const vertex )
+    {
+        if( ! admitted[ vertex ] && ( m_filter.empty() || m_filter[ vertex ] ) )
+        {
+            admitted[ vertex ] = 1;
+            ++num_admitted;
+        }
+    };
+    vertex_list_t region;
+    for( auto const& [ u, v ] : inserted )
+    {
+        if( m_in_core[ u ] && m_in_core[ v ] )
+        {
+            vertex_list_t const around_u = GetCoreNeighbourhood( u );
+            GetIntersection( around_u, GetCoreNeighbourhood( v ), region );
+            std::ranges::for_each( region, Admit );
+        }
+    }
+    if( ! evicted.empty() )
+    {
+        for( vertex_id_t const vertex : std::views::iota( 0, m_graph.size ) )
+        {
+            GroupStore::point_view_t const label( m_graph.labels[ vertex ] );
+            if( m_in_core[ vertex ] && std::ranges::any_of( evicted, [ & ]( std::size_t const i ){ return IsWeaklyBetter( m_skyline.Best( i ), label ); } ) )
+            {
+                Admit( vertex );
+            }
+        }
+    }
+
+    GroupStore candidates;
+    if( num_admitted >= static_cast< std::size_t >( m_query.groupSize ) )
+    {
+        candidates = Compute( admitted );
+    }
+    return Merge( std::move( keep ), candidates );
+}
+
+auto DynamicSkyline::ApplyLabelUpdates( std::vector< LabelUpdate > const& updates ) -> SkylineDelta
+{
+    std::size_t const num_dimensions = m_graph.labels.empty() ? 0 : m_graph.labels.front().size();
+    std::vector< char > is_updated( m_graph.size, 0 );
+    for( auto const& update : updates )
+    {
+        if( update.label.size() != num_dimensions )
+        {
+            throw std::invalid_argument( "label update for vertex " + std::to_string( update.vertex ) + " has the wrong dimension" );
+        }
+        is_updated[ ToRelabelled( update.vertex ) ] = 1;
+    }
+
+    // re-evaluate the skyline groups with an updated member, and admit the groups that they dominated before
+    std::vector< bool > keep( m_skyline.size(), true );
+    label_list_t stale_bests;
+    for( std::size_t i = 0; i < m_skyline.size(); ++i )
+    {
+        if( std::ranges::any_of( m_skyline[ i ], [ &is_updated ]( vertex_id_t const member ){ return is_updated[ member ] != 0; } ) )
+        {
+            keep[ i ] = false;
+            stale_bests.emplace_back( std::cbegin( m_skyline.Best( i ) ), std::cend( m_skyline.Best( i ) ) );
+        }
+    }
+
+    std::size_t const max_shifted = static_cast< std::size_t >( m_graph.size ) / max_shift_divisor;
+    std::size_t num_shifted = 0;
+    for( auto const& update : updates )
+    {
+        vertex_id_t const vertex = m_graph.toRelabelled[ update.vertex ];
+        m_graph.labels[ vertex ] = update.label;
+        if( num_shifted <= max_shifted )
+        {
+            num_shifted += Reposition( vertex );
+        }
+    }
+    if( num_shifted > max_shifted )
+    {
+        return Rebuild();
+    }
+    if( ! m_query.filter.IsEmpty() )
+    {
+        m_filter = GetAdmittedVertices( m_query.filter, m_graph ); // label ranges may admit other vertices now
+    }
+
+    std::vector< char > admitted( m_graph.size, 0 );
+    std::size_t num_admitted = 0;
+    auto const Admit = [ & ]( vertex_id_t const vertex )
+    {
+        if( ! admitted[ vertex ] && ( m_filter.empty() || m_filter[ vertex ] ) )
+        {
+            admitted[ vertex ] = 1;
+            ++num_admitted;
+        }
+    };
+    for( auto const& update : updates )
+    {
+        if( vertex_id_t const vertex = m_graph.toRelabelled[ update.vertex ]; m_in_core[ vertex ] )
+        {
+            std::ranges::for_each( GetCoreNeighbourhood( vertex ), Admit );
+        }
+    }
+    for( vertex_id_t const vertex : std::views::iota( 0, stale_bests.empty() ? 0 : m_graph.size ) )
+    {
+        GroupStore::point_view_t const label( m_graph.labels[ vertex ] );
+        if( m_in_core[ vertex ] && std::ranges::any_of( stale_bests, [ &label ]( vertex_label_t const& best ){ return IsWeaklyBetter( best, label ); } ) )
+        {
+            Admit( vertex );
+        }
+    }
+
+    GroupStore candidates;
+    if( num_admitted >= static_cast< std::size_t >( m_query.groupSize ) )
+    {
+        candidates = Compute( admitted );
+    }
+    return Merge( std::move( keep ), candidates );
+}
+
+auto DynamicSkyline::GetSkyline() const -> group_list_t
+{
+    return ToOriginalIds( m_skyline.ToGroupList(), m_graph );
+}
+
+auto DynamicSkyline::ToRelabelled( vertex_id_t const original ) const -> vertex_id_t
+{
+    if( original < 0 || original >= m_graph.size )
+    {
+        throw std::invalid_argument( "update names unknown vertex " + std::to_string( original ) );
+    }
+    return m_graph.toRelabelled[ original ];
+}
+
+void DynamicSkyline::InitialiseCore()
+{
+    auto [ sortedIndices, nodePosition, binBoundaries ] = BinSortByDegree( m_graph.edges );
+    m_in_core.assign( m_graph.size, 1 );
+    ShrinkToMaxKCoreVertices( m_query.GetCoreSize(), std::nullopt, m_graph.edges, sortedIndices, nodePosition, binBoundaries, m_in_core );
+    m_core_degree.resize( m_graph.size );
+    for( vertex_id_t const vertex : std::views::iota( 0, m_graph.size ) )
+    {
+        m_core_degree[ vertex ] = std::ranges::count_if( m_graph.edges[ vertex ], [ this ]( vertex_id_t const neighbour ){ return m_in_core[ neighbour ] != 0; } );
+    }
+}
+
+auto DynamicSkyline::Reposition( vertex_id_t const vertex ) -> std::size_t
+{
+    // the other vertices are in a valid order, so every vertex that dominates this one precedes every one that it dominates,
+    // and those with a label equal to its own are adjacent and lie in between
+    auto const& label = m_graph.labels[ vertex ];
+    vertex_id_t last_dominating = -1;
+    vertex_id_t first_dominated = m_graph.size;
+    vertex_id_t first_equal = -1;
+    vertex_id_t last_equal = -1;
+    for( vertex_id_t const other : std::views::iota( 0, m_graph.size ) )
+    {
+        if( other == vertex )
+        {
+            continue;
+        }
+        auto const& other_label = m_graph.labels[ other ];
+        if( other_label == label )
+        {
+            first_equal = first_equal < 0 ? other : first_equal;
+            last_equal = other;
+        }
+        else if( PointDominanceTest( std::cbegin( other_label ), std::cend( other_label ), std::cbegin( label ) ) == DominanceTestResult::dominates )
+        {
+            last_dominating = other;
+        }
+        else if( first_dominated == m_graph.size
+              && PointDominanceTest( std::cbegin( label ), std::cend( label ), std::cbegin( other_label ) ) == DominanceTestResult::dominates )
+        {
+            first_dominated = other;
+        }
+    }
+
+    // positions among the other vertices: position p is just before the p-th of them, and this vertex is at position vertex
+    auto const PositionOf = [ vertex ]( vertex_id_t const other ){ return other < vertex ? other : other - 1; };
+    auto const LabelAt = [ this, vertex ]( vertex_id_t const p ) -> vertex_label_t const& { return m_graph.labels[ p < vertex ? p : p + 1 ]; };
+    vertex_id_t position;
+    if( first_equal >= 0 )
+    {
+        position = std::clamp( vertex, PositionOf( first_equal ), PositionOf( last_equal ) + 1 );
+    }
+    else
+    {
+        position = std::clamp( vertex, PositionOf( last_dominating ) + 1, PositionOf( first_dominated ) );
+        // step out of a run of equal labels to its nearer end; all of the run is incomparable to this vertex
+        if( 0 < position && position < m_graph.size - 1 && LabelAt( position - 1 ) == LabelAt( position ) )
+        {
+            vertex_id_t start = position - 1;
+            vertex_id_t end = position + 1;
+            while( start > 0 && LabelAt( start - 1 ) == LabelAt( position ) ) { --start; }
+            while( end < m_graph.size - 1 && LabelAt( end ) == LabelAt( position ) ) { ++end; }
+            position = position - start <= end - position ? start : end;
+        }
+    }
+
+    if( position != vertex )
+    {
+        MoveVertex( vertex, position );
+    }
+    LowerRepresentatives( position, m_graph.labels[ position ] );
+    return std::abs( position - vertex );
+}
+
+void DynamicSkyline::MoveVertex( vertex_id_t const from, vertex_id_t const to )
+{
+    vertex_id_t const first = std::min( from, to );
+    vertex_id_t const last = std::max( from, to );
+    auto const NewId = [ = ]( vertex_id_t const vertex ) -> vertex_id_t
+    {
+        if( vertex < first || vertex > last ) { return vertex; }
+        if( vertex == from )                  { return to; }
+        return from < to ? vertex - 1 : vertex + 1;
+    };
+    auto const Rotate = [ = ]( auto & values )
+    {
+        auto const begin = std::begin( values );
+        std::rotate( begin + first, from < to ? begin + first + 1 : begin + last, begin + last + 1 );
+    };
+
+    Rotate( m_graph.labels );
+    Rotate( m_graph.edges );
+    Rotate( m_graph.toOriginal );
+    Rotate( m_in_core );
+    Rotate( m_core_degree );
+    if( ! m_filter.empty() )
+    {
+        Rotate( m_filter );
+    }
+    for( vertex_id_t const vertex : std::views::iota( first, last + 1 ) )
+    {
+        m_graph.toRelabelled[ m_graph.toOriginal[ vertex ] ] = vertex;
+    }
+
+    // renumber the moved vertices in their own adjacency lists and those of their neighbours
+    vertex_list_t affected;
+    for( vertex_id_t const vertex : std::views::iota( first, last + 1 ) )
+    {
+        affected.push_back( vertex );
+        std::ranges::transform( m_graph.edges[ vertex ], std::back_inserter( affected ), NewId );
+    }
+    std::ranges::sort( affected );
+    affected.erase( std::unique( std::begin( affected ), std::end( affected ) ), std::end( affected ) );
+    for( vertex_id_t const vertex : affected )
+    {
+        auto & neighbours = m_graph.edges[ vertex ];
+        std::ranges::transform( neighbours, std::begin( neighbours ), NewId );
+        std::ranges::sort( neighbours, std::greater{} );
+    }
+
+    // a vertex shifted onto the first position of a layer now joins it
+    for( std::size_t layer = 0; to < from && layer + 1 < m_graph.skyLayersBoundaries.size(); ++layer )
+    {
+        if( vertex_id_t const boundary = m_graph.skyLayersBoundaries[ layer ]; first < boundary && boundary <= last )
+        {
+            LowerRepresentatives( boundary, m_graph.labels[ boundary ] );
+        }
+    }
+
+    GroupStore skyline( m_skyline.GetGroupSize(), m_skyline.GetNumDimensions() );
+    skyline.reserve( m_skyline.size() );
+    vertex_list_t group;
+    for( auto const members : m_skyline )
+    {
+        group.clear();
+        std::ranges::transform( members, std::back_inserter( group ), NewId );
+        std::ranges::sort( group );
+        skyline.Append( group, m_graph.labels );
+    }
+    m_skyline = std::move( skyline );
+}
+
+void DynamicSkyline::LowerRepresentatives( vertex_id_t const position, vertex_label_t const& label )
+{
+    for( std::size_t layer = 0; layer + 1 < m_graph.skyLayersBoundaries.size() && m_graph.skyLayersBoundaries[ layer ] <= position; ++layer )
+    {
+        auto & representative = m_graph.layerRepresentatives[ layer ];
+        std::ranges::transform( representative, label, std::begin( representative ), []( coordinate_t const a, coordinate_t const b ){ return std::min( a, b ); } );
+    }
+}
+
+auto DynamicSkyline::Rebuild() -> SkylineDelta
+{
+    group_list_t previous = GetSkyline();
+
+    // restore the ids of the input files, so that the graph can be preprocessed afresh
+    Graph graph;
+    graph.size = m_graph.size;
+    graph.edges.resize( m_graph.size );
+    graph.labels.resize( m_graph.size );
+    for( vertex_id_t const vertex : std::views::iota( 0, m_graph.size ) )
+    {
+        vertex_id_t const original = m_graph.toOriginal[ vertex ];
+        std::ranges::transform( m_graph.edges[ vertex ], std::back_inserter( graph.edges[ original ] ), [ this ]( vertex_id_t const neighbour ){ return m_graph.toOriginal[ neighbour ]; } );
+        graph.labels[ original ] = std::move( m_graph.labels[ vertex ] );
+    }
+    UpdateGraph( graph );
+    m_graph = std::move( graph );
+
+    if( ! m_query.filter.IsEmpty() )
+    {
+        m_filter = GetAdmittedVertices( m_query.filter, m_graph );
+    }
+    InitialiseCore();
+    m_skyline = Compute( m_filter );
+
+    group_list_t current = GetSkyline();
+    for( auto * groups : { &previous, &current } )
+    {
+        std::ranges::for_each( *groups, []( vertex_list_t & group ){ std::ranges::sort( group ); } );
+        std::ranges::sort( *groups );
+    }
+    SkylineDelta delta;
+    std::ranges::set_difference( current, previous, std::back_inserter( delta.added ) );
+    std::ranges::set_difference( previous, current, std::back_inserter( delta.removed ) );
+    return delta;
+}
+
+bool DynamicSkyline::InsertEdge( vertex_id_t const u, vertex_id_t const v )
+{
+    auto & u_neighbours = m_graph.edges[ u ];
+    auto & v_neighbours = m_graph.edges[ v ];
+    auto const position = std::ranges::lower_bound( u_neighbours, v, std::greater{} ); // lists are in descending order
+    if( u == v || ( position != std::end( u_neighbours ) && *position == v ) )
+    {
+        return false;
+    }
+    u_neighbours.insert( position, v );
+    v_neighbours.insert( std::ranges::lower_bound( v_neighbours, u, std::greater{} ), u );
+
+    if( m_in_core[ u ] ) { ++m_core_degree[ v ]; }
+    if( m_in_core[ v ] ) { ++m_core_degree[ u ]; }
+    vertex_list_t roots;
+    if( ! m_in_core[ u ] ) { roots.push_back( u ); }
+    if( ! m_in_core[ v ] ) { roots.push_back( v ); }
+    if( ! roots.empty() )
+    {
+        GrowCore( roots );
+    }
+    return true;
+}
+
+bool DynamicSkyline::DeleteEdge( vertex_id_t const u, vertex_id_t const v )
+{
+    auto & u_neighbours = m_graph.edges[ u ];
+    auto & v_neighbours = m_graph.edges[ v ];
+    auto const position = std::ranges::lower_bound( u_neighbours, v, std::greater{} );
+    if( position == std::end( u_neighbours ) || *position != v )
+    {
+        return false;
+    }
+    u_neighbours.erase( position );
+    v_neighbours.erase( std::ranges::lower_bound( v_neighbours, u, std::greater{} ) );
+
+    if( m_in_core[ u ] ) { --m_core_degree[ v ]; }
+    if( m_in_core[ v ] ) { --m_core_degree[ u ]; }
+    PeelFromCore( { u, v } );
+    return true;
+}
+
+void DynamicSkyline::PeelFromCore( vertex_list_t queue )
+{
+    vertex_degree_t const coreSize = m_query.GetCoreSize();
+    while( ! queue.empty() )
+    {
+        vertex_id_t const vertex = queue.back();
+        queue.pop_back();
+        if( ! m_in_core[ vertex ] || m_core_degree[ vertex ] >= coreSize )
+        {
+            continue;
+        }
+        m_in_core[ vertex ] = 0;
+        for( vertex_id_t const neighbour : m_graph.edges[ vertex ] )
+        {
+            if( --m_core_degree[ neighbour ] < coreSize && m_in_core[ neighbour ] )
+            {
+                queue.push_back( neighbour );
+            }
+        }
+    }
+}
+
+void DynamicSkyline::GrowCore( vertex_list_t const& roots )
+{
+    // Every vertex that joins the core is connected to a root through others that join, so the
+    // candidates are the non-core vertices reachable from the roots through vertices of sufficient degree
+    vertex_degree_t const coreSize = m_query.GetCoreSize();
+    std::unordered_map< vertex_id_t, vertex_degree_t > support; // of each candidate, from the core and other candidates
+    vertex_list_t stack;
+    auto const Visit = [ & ]( vertex_id_t const vertex )
+    {
+        if( ! m_in_core[ vertex ] && GetDegree( m_graph.edges, vertex ) >= coreSize && support.emplace( vertex, 0 ).second )
+        {
+            stack.push_back( vertex );
+        }
+    };
+    std::ranges::for_each( roots, Visit );
+    while( ! stack.empty() )
+    {
+        vertex_id_t const vertex = stack.back();
+        stack.pop_back();
+        std::ranges::for_each( m_graph.edges[ vertex ], Visit );
+    }
+
+    for( auto & [ vertex, count ] : support )
+    {
+        count = m_core_degree[ vertex ] + std::ranges::count_if( m_graph.edges[ vertex ], [ &support ]( vertex_id_t const neighbour ){ return support.contains( neighbour ); } );
+        if( count < coreSize )
+        {
+            stack.push_back( vertex );
+        }
+    }
+
+    // Peel the candidates that lack support; a count of -1 marks a peeled candidate
+    while( ! stack.empty() )
+    {
+        vertex_id_t const vertex = stack.back();
+        stack.pop_back();
+        if( support[ vertex ] < 0 )
+        {
+            continue;
+        }
+        support[ vertex ] = -1;
+        for( vertex_id_t const neighbour : m_graph.edges[ vertex ] )
+        {
+            if( auto const candidate = support.find( neighbour ); candidate != std::end( support ) && candidate->second >= 0 && --candidate->second < coreSize )
+            {
+                stack.push_back( neighbour );
+            }
+        }
+    }
+
+    for( auto const& [ vertex, count ] : support )
+    {
+        if( count >= 0 )
+        {
+            m_in_core[ vertex ] = 1;
+            for( vertex_id_t const neighbour : m_graph.edges[ vertex ] )
+            {
+                ++m_core_degree[ neighbour ];
+            }
+        }
+    }
+}
+
+auto DynamicSkyline::GetCoreNeighbourhood( vertex_id_t const u ) const -> vertex_list_t
+{
+    int const num_hops = m_query.groupSize - m_query.GetCoreSize() == 1 ? 1 : 2;
+    vertex_list_t neighbourhood = { u };
+    vertex_list_t frontier = { u };
+    vertex_list_t reached;
+    vertex_list_t merged;
+    for( int hop = 0; hop < num_hops && ! frontier.empty(); ++hop )
+    {
+        reached.clear();
+        for( vertex_id_t const vertex : frontier )
+        {
+            std::ranges::copy_if( m_graph.edges[ vertex ], std::back_inserter( reached ), [ this ]( vertex_id_t const neighbour ){ return m_in_core[ neighbour ] != 0; } );
+        }
+        std::ranges::sort( reached );
+        reached.erase( std::unique( std::begin( reached ), std::end( reached ) ), std::end( reached ) );
+
+        frontier.clear();
+        std::ranges::set_difference( reached, neighbourhood, std::back_inserter( frontier ) );
+        merged.clear();
+        std::ranges::set_union( neighbourhood, frontier, std::back_inserter( merged ) );
+        std::swap( neighbourhood, merged );
+    }
+    return neighbourhood;
+}
+
+auto DynamicSkyline::Compute( std::vector< char > const& admitted ) const -> GroupStore
+{
+    QueryContext context;
+    context.admitted = admitted;
+    int const coreSize = m_query.GetCoreSize();
+    group_list_t groups = m_query.algorithm == Algorithm::pkcore
+        ? parallel::GetSkylineCommunities( m_graph, coreSize, m_query.groupSize, m_query.nThreads, context )
+        : sequential::GetSkylineCommunities( m_graph, coreSize, m_query.groupSize, context );
+
+    GroupStore store( m_query.groupSize, m_graph.labels.empty() ? 0 : m_graph.labels.front().size() );
+    store.reserve( groups.size() );
+    for( auto & group : groups )
+    {
+        std::ranges::sort( group );
+        store.Append( group, m_graph.labels );
+    }
+    return store;
+}
+
+auto DynamicSkyline::Merge( std::vector< bool > keep, GroupStore const& candidates ) -> SkylineDelta
+{
+    // The candidates are a skyline of their own, so none dominates another, and a surviving group that
+    // dominates a candidate cannot itself be dominated by another candidate
+    std::vector< bool > is_added( candidates.size(), false );
+    for( std::size_t j = 0; j < candidates.size(); ++j )
+    {
+        bool is_known = false;
+        for( std::size_t i = 0; i < m_skyline.size() && ! is_known; ++i )
+        {
+            is_known = keep[ i ] && ( std::ranges::equal( m_skyline[ i ], candidates[ j ] )
+                                   || GroupDominates( m_skyline, i, candidates, j, m_graph.labels ) );
+        }
+        if( is_known )
+        {
+            continue;
+        }
+        is_added[ j ] = true;
+        for( std::size_t i = 0; i < m_skyline.size(); ++i )
+        {
+            if( keep[ i ] && GroupDominates( candidates, j, m_skyline, i, m_graph.labels ) )
+            {
+                keep[ i ] = false;
+            }
+        }
+    }
+
+    SkylineDelta delta;
+    for( std::size_t i = 0; i < m_skyline.size(); ++i )
+    {
+        if( ! keep[ i ] )
+        {
+            delta.removed.emplace_back( std::cbegin( m_skyline[ i ] ), std::cend( m_skyline[ i ] ) );
+        }
+    }
+    m_skyline.Compact( keep );
+    for( std::size_t j = 0; j < candidates.size(); ++j )
+    {
+        if( is_added[ j ] )
+        {
+            m_skyline.Append( candidates, j );
+            delta.added.emplace_back( std::cbegin( candidates[ j ] ), std::cend( candidates[ j ] ) );
+        }
+    }
+
+    delta.added = ToOriginalIds( std::move( delta.added ), m_graph );
+    delta.removed = ToOriginalIds( std::move( delta.removed ), m_graph );
+    return delta;
+}
+
+} // namespace base
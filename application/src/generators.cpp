@@ -0,0 +1,470 @@
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+
+#include "generators.hpp"
+
+namespace { // anonymous
+
+std::size_t constexpr edge_chunk_size  = 1 << 16; // edges sampled per chunk, i.e., per random number generator
+std::size_t constexpr label_chunk_size = 1 << 14; // labels generated per chunk
+
+/**
+ * One step of the SplitMix64 generator, used to derive well-mixed seeds for each chunk
+ */
+auto SplitMix64( std::uint64_t x ) -> std::uint64_t
+{
+    x += 0x9e3779b97f4a7c15ull;
+    x = ( x ^ ( x >> 30 ) ) * 0xbf58476d1ce4e5b9ull;
+    x = ( x ^ ( x >> 27 ) ) * 0x94d049bb133111ebull;
+    return x ^ ( x >> 31 );
+}
+
+auto ChunkGenerator( std::uint64_t const seed, std::size_t const chunk ) -> std::mt19937_64
+{
+    return std::mt19937_64( SplitMix64( seed ^ SplitMix64( chunk ) ) );
+}
+
+auto NumChunks( std::size_t const num_items, std::size_t const chunk_size ) -> std::size_t
+{
+    return ( num_items + chunk_size - 1 ) / chunk_size;
+}
+
+void CheckGraphParameters( vertex_id_t const num_vertices, double const average_degree )
+{
+    if( num_vertices < 2 || average_degree <= 0 || average_degree >= num_vertices )
+    {
+        throw std::invalid_argument( "need at least two vertices and an average degree between 0 and the number of vertices" );
+    }
+}
+
+/**
+ * Draws num_samples vertex pairs in parallel with the given sampler, drops self loops and duplicates,
+ * and returns the remaining edges with u < v in ascending order
+ */
+template < typename EdgeSampler >
+auto SampleEdges( std::size_t const num_samples, std::uint64_t const seed, EdgeSampler const& sample ) -> generators::edge_list_t
+{
+    std::size_t const num_chunks = NumChunks( num_samples, edge_chunk_size );
+    std::vector< generators::edge_list_t > chunks( num_chunks );
+
+    #pragma omp parallel for schedule( dynamic )
+    for( std::size_t chunk = 0; chunk < num_chunks; ++chunk )
+    {
+        auto generator = ChunkGenerator( seed, chunk );
+        std::size_t const chunk_samples = std::min( edge_chunk_size, num_samples - chunk * edge_chunk_size );
+
+        auto & edges = chunks[ chunk ];
+        edges.reserve( chunk_samples );
+        for( std::size_t i = 0; i < chunk_samples; ++i )
+        {
+            auto const [ u, v ] = sample( generator );
+            if( u != v )
+            {
+                edges.emplace_back( std::min( u, v ), std::max( u, v ) );
+            }
+        }
+        std::sort( std::begin( edges ), std::end( edges ) );
+    }
+
+    // concatenate the sorted chunks and merge them pairwise in a tree, one level at a time
+    std::vector< std::size_t > run_starts = { 0 };
+    generators::edge_list_t edges;
+    for( auto const& chunk_edges : chunks )
+    {
+        edges.insert( std::end( edges ), std::cbegin( chunk_edges ), std::cend( chunk_edges ) );
+        run_starts.push_back( edges.size() );
+    }
+    chunks.clear();
+
+    for( std::size_t width = 1; width < num_chunks; width *= 2 )
+    {
+        #pragma omp parallel for schedule( dynamic )
+        for( std::size_t first = 0; first < num_chunks - width; first += 2 * width )
+        {
+            std::size_t const last = std::min( first + 2 * width, num_chunks );
+            std::inplace_merge( std::begin( edges ) + run_starts[ first ]
+                              , std::begin( edges ) + run_starts[ first + width ]
+                              , std::begin( edges ) + run_starts[ last ] );
+        }
+    }
+
+    edges.erase( std::unique( std::begin( edges ), std::end( edges ) ), std::end( edges ) );
+    return edges;
+}
+
+/**
+ * Generates raw, real-valued coordinates in parallel with the given point generator and then
+ * min-max scales every dimension to integers between low and high, as the preprocessing notebook does
+ */
+template < typename PointGenerator >
+auto GenerateScaledLabels( vertex_id_t const num_vertices
+                         , dimension_t const num_dimensions
+                         , std::uint64_t const seed
+                         , coordinate_t const low
+                         , coordinate_t const high
+                         , PointGenerator const& generate_point ) -> label_list_t
+{
+    std::size_t const num_chunks = NumChunks( num_vertices, label_chunk_size );
+    std::vector< double > raw( static_cast< std::size_t >( num_vertices ) * num_dimensions );
+    std::vector< std::vector< double > > chunk_min( num_chunks, std::vector< double >( num_dimensions,  HUGE_VAL ) );
+    std::vector< std::vector< double > > chunk_max( num_chunks, std::vector< double >( num_dimensions, -HUGE_VAL ) );
+
+    #pragma omp parallel for schedule( dynamic )
+    for( std::size_t chunk = 0; chunk < num_chunks; ++chunk )
+    {
+        auto generator = ChunkGenerator( seed, chunk );
+        std::size_t const end = std::min( ( chunk + 1 ) * label_chunk_size, static_cast< std::size_t >( num_vertices ) );
+        for( std::size_t i = chunk * label_chunk_size; i < end; ++i )
+        {
+            double * const point = raw.data() + i * num_dimensions;
+            generate_point( generator, point );
+            for( dimension_t d = 0; d < num_dimensions; ++d )
+            {
+                chunk_min[ chunk ][ d ] = std::min( chunk_min[ chunk ][ d ], point[ d ] );
+                chunk_max[ chunk ][ d ] = std::max( chunk_max[ chunk ][ d ], point[ d ] );
+            }
+        }
+    }
+
+    std::vector< double > minimum( num_dimensions, HUGE_VAL );
+    std::vector< double > maximum( num_dimensions, -HUGE_VAL );
+    for( std::size_t chunk = 0; chunk < num_chunks; ++chunk )
+    {
+        for( dimension_t d = 0; d < num_dimensions; ++d )
+        {
+            minimum[ d ] = std::min( minimum[ d ], chunk_min[ chunk ][ d ] );
+            maximum[ d ] = std::max( maximum[ d ], chunk_max[ chunk ][ d ] );
+        }
+    }
+
+    label_list_t labels( num_vertices, vertex_label_t( num_dimensions ) );
+    #pragma omp parallel for schedule( static )
+    for( vertex_id_t i = 0; i < num_vertices; ++i )
+    {
+        for( dimension_t d = 0; d < num_dimensions; ++d )
+        {
+            double const range = maximum[ d ] - minimum[ d ];
+            double const normalised = range > 0 ? ( raw[ static_cast< std::size_t >( i ) * num_dimensions + d ] - minimum[ d ] ) / range : 0.0;
+            labels[ i ][ d ] = low + static_cast< coordinate_t >( normalised * ( high - low ) );
+        }
+    }
+    return labels;
+}
+
+void CheckLabelParameters( vertex_id_t const num_vertices, dimension_t const num_dimensions, coordinate_t const low, coordinate_t const high )
+{
+    if( num_vertices < 0 || num_dimensions < 1 || high <= low )
+    {
+        throw std::invalid_argument( "need a non-negative number of vertices, at least one dimension and low < high" );
+    }
+}
+
+/**
+ * Formats consecutive chunks of items in parallel and writes them in order, after a header
+ */
+template < typename Items, typename Formatter >
+bool WriteInChunks( std::string const& filePath, Items const& items, Formatter const& format, std::string const& header = {} )
+{
+    std::ofstream file( filePath, std::ios::binary );
+    if( ! file.is_open() )
+    {
+        return false;
+    }
+    file.write( header.data(), header.size() );
+
+    std::size_t constexpr chunk_size = 1 << 16;
+    std::size_t const num_chunks = NumChunks( items.size(), chunk_size );
+    std::vector< std::string > buffers( num_chunks );
+
+    #pragma omp parallel for ordered schedule( dynamic )
+    for( std::size_t chunk = 0; chunk < num_chunks; ++chunk )
+    {
+        std::size_t const end = std::min( ( chunk + 1 ) * chunk_size, items.size() );
+        for( std::size_t i = chunk * chunk_size; i < end; ++i )
+        {
+            format( items[ i ], buffers[ chunk ] );
+        }
+
+        #pragma omp ordered
+        {
+            file.write( buffers[ chunk ].data(), buffers[ chunk ].size() );
+            buffers[ chunk ] = std::string();
+        }
+    }
+    return file.good();
+}
+
+/**
+ * Appends the bytes of a value as they are in memory, for the binary formats (see IsBinaryFile)
+ */
+template < typename T >
+void AppendRaw( std::string & buffer, T const value )
+{
+    buffer.append( reinterpret_cast< char const* >( &value ), sizeof( T ) );
+}
+
+void AppendNumber( std::string & buffer, int const number )
+{
+    char digits[ 16 ];
+    auto const end = std::to_chars( std::begin( digits ), std::end( digits ), number ).ptr;
+    buffer.append( digits, end );
+}
+
+} // namespace anonymous
+
+
+namespace generators
+{
+
+auto GenerateRmat( vertex_id_t const num_vertices
+                 , double const average_degree
+                 , RmatParameters const& parameters
+                 , std::uint64_t const seed ) -> edge_list_t
+{
+    CheckGraphParameters( num_vertices, average_degree );
+    if( parameters.a < 0 || parameters.b < 0 || parameters.c < 0 || parameters.a + parameters.b + parameters.c > 1 )
+    {
+        throw std::invalid_argument( "R-MAT probabilities must be non-negative and sum to at most one" );
+    }
+
+    int const scale = std::ceil( std::log2( num_vertices ) );
+    auto const sample = [ & ]( std::mt19937_64 & generator ) -> edge_t
+    {
+        std::uniform_real_distribution< double > quadrant( 0.0, 1.0 );
+        for( ;; ) // reject pairs beyond num_vertices if it is not a power of two
+        {
+            vertex_id_t u = 0;
+            vertex_id_t v = 0;
+            for( int level = 0; level < scale; ++level )
+            {
+                double const r = quadrant( generator );
+                bool const lower = r >= parameters.a + parameters.b;
+                bool const right = ( r >= parameters.a && r < parameters.a + parameters.b ) || r >= parameters.a + parameters.b + parameters.c;
+                u = 2 * u + lower;
+                v = 2 * v + right;
+            }
+            if( u < num_vertices && v < num_vertices )
+            {
+                return { u, v };
+            }
+        }
+    };
+    return SampleEdges( static_cast< std::size_t >( num_vertices * average_degree / 2 ), seed, sample );
+}
+
+auto GenerateChungLu( vertex_id_t const num_vertices
+                    , double const average_degree
+                    , double const exponent
+                    , std::uint64_t const seed ) -> edge_list_t
+{
+    CheckGraphParameters( num_vertices, average_degree );
+    if( exponent <= 1 )
+    {
+        throw std::invalid_argument( "the power-law exponent must exceed one" );
+    }
+
+    // endpoints are drawn proportionally to their weights, so that expected degrees follow the weights
+    std::vector< double > cumulative_weights( num_vertices );
+    double total = 0;
+    for( vertex_id_t i = 0; i < num_vertices; ++i )
+    {
+        total += std::pow( i + 1, -1.0 / ( exponent - 1 ) );
+        cumulative_weights[ i ] = total;
+    }
+
+    auto const sample = [ & ]( std::mt19937_64 & generator ) -> edge_t
+    {
+        std::uniform_real_distribution< double > position( 0.0, total );
+        auto const Draw = [ & ]
+        {
+            auto const it = std::upper_bound( std::cbegin( cumulative_weights ), std::cend( cumulative_weights ), position( generator ) );
+            return static_cast< vertex_id_t >( std::min< std::ptrdiff_t >( std::distance( std::cbegin( cumulative_weights ), it ), num_vertices - 1 ) );
+        };
+        vertex_id_t const u = Draw();
+        return { u, Draw() };
+    };
+    return SampleEdges( static_cast< std::size_t >( num_vertices * average_degree / 2 ), seed, sample );
+}
+
+auto GeneratePlantedCommunities( vertex_id_t const num_vertices
+                               , double const average_degree
+                               , vertex_id_t const num_communities
+                               , double const mixing
+                               , std::uint64_t const seed ) -> edge_list_t
+{
+    CheckGraphParameters( num_vertices, average_degree );
+    if( num_communities < 1 || num_communities > num_vertices || mixing < 0 || mixing > 1 )
+    {
+        throw std::invalid_argument( "need between one and num_vertices communities and a mixing parameter in [0, 1]" );
+    }
+
+    vertex_id_t const community_size = ( num_vertices + num_communities - 1 ) / num_communities;
+    auto const sample = [ & ]( std::mt19937_64 & generator ) -> edge_t
+    {
+        std::uniform_int_distribution< vertex_id_t > any_vertex( 0, num_vertices - 1 );
+        std::bernoulli_distribution crosses_communities( mixing );
+
+        vertex_id_t const u = any_vertex( generator );
+        if( crosses_communities( generator ) )
+        {
+            return { u, any_vertex( generator ) };
+        }
+        vertex_id_t const first = u / community_size * community_size;
+        vertex_id_t const last = std::min( first + community_size, num_vertices ) - 1;
+        return { u, std::uniform_int_distribution< vertex_id_t >( first, last )( generator ) };
+    };
+    return SampleEdges( static_cast< std::size_t >( num_vertices * average_degree / 2 ), seed, sample );
+}
+
+auto GenerateIndependentLabels( vertex_id_t const num_vertices
+                              , dimension_t const num_dimensions
+                              , std::uint64_t const seed
+                              , coordinate_t const low
+                              , coordinate_t const high ) -> label_list_t
+{
+    CheckLabelParameters( num_vertices, num_dimensions, low, high );
+
+    label_list_t labels( num_vertices, vertex_label_t( num_dimensions ) );
+    std::size_t const num_chunks = NumChunks( num_vertices, label_chunk_size );
+
+    #pragma omp parallel for schedule( dynamic )
+    for( std::size_t chunk = 0; chunk < num_chunks; ++chunk )
+    {
+        auto generator = ChunkGenerator( seed, chunk );
+        std::uniform_int_distribution< coordinate_t > coordinate( low, high - 1 );
+        std::size_t const end = std::min( ( chunk + 1 ) * label_chunk_size, static_cast< std::size_t >( num_vertices ) );
+        for( std::size_t i = chunk * label_chunk_size; i < end; ++i )
+        {
+            std::generate( std::begin( labels[ i ] ), std::end( labels[ i ] ), [ & ]{ return coordinate( generator ); } );
+        }
+    }
+    return labels;
+}
+
+auto GenerateCorrelatedLabels( vertex_id_t const num_vertices
+                             , dimension_t const num_dimensions
+                             , std::uint64_t const seed
+                             , coordinate_t const low
+                             , coordinate_t const high
+                             , double const scale ) -> label_list_t
+{
+    CheckLabelParameters( num_vertices, num_dimensions, low, high );
+
+    // a random point on the line through the origin and (1, ..., 1), perturbed within the hyperplane perpendicular to it
+    auto const generate_point = [ & ]( std::mt19937_64 & generator, double * point )
+    {
+        double const p = std::normal_distribution< double >( 0.0, 1.0 )( generator );
+        std::normal_distribution< double > offset( p, scale );
+        double sum = 0;
+        for( dimension_t d = 0; d < num_dimensions - 1; ++d )
+        {
+            point[ d ] = offset( generator );
+            sum += point[ d ];
+        }
+        point[ num_dimensions - 1 ] = p * num_dimensions - sum;
+    };
+    return GenerateScaledLabels( num_vertices, num_dimensions, seed, low, high, generate_point );
+}
+
+auto GenerateAnticorrelatedLabels( vertex_id_t const num_vertices
+                                 , dimension_t const num_dimensions
+                                 , std::uint64_t const seed
+                                 , coordinate_t const low
+                                 , coordinate_t const high ) -> label_list_t
+{
+    CheckLabelParameters( num_vertices, num_dimensions, low, high );
+
+    // a uniformly random point on a hyperplane perpendicular to (1, ..., 1), close to its centre
+    auto const generate_point = [ & ]( std::mt19937_64 & generator, double * point )
+    {
+        double const p = std::normal_distribution< double >( 0.5, 0.05 )( generator );
+        std::uniform_real_distribution< double > coordinate( 0.0, 1.0 );
+        double sum = 0;
+        for( dimension_t d = 0; d < num_dimensions - 1; ++d )
+        {
+            point[ d ] = coordinate( generator );
+            sum += point[ d ];
+        }
+        point[ num_dimensions - 1 ] = p * num_dimensions - sum;
+    };
+    return GenerateScaledLabels( num_vertices, num_dimensions, seed, low, high, generate_point );
+}
+
+auto ToAdjacencyList( edge_list_t const& edges, vertex_id_t const num_vertices ) -> adjacency_list_t
+{
+    adjacency_list_t adjacency( num_vertices );
+    for( auto const& [ u, v ] : edges )
+    {
+        adjacency[ u ].push_back( v );
+        adjacency[ v ].push_back( u );
+    }
+    for( auto & neighbours : adjacency )
+    {
+        std::sort( std::begin( neighbours ), std::end( neighbours ) );
+    }
+    return adjacency;
+}
+
+bool WriteEdges( std::string const& filePath, edge_list_t const& edges )
+{
+    if( IsBinaryFile( filePath ) )
+    {
+        vertex_id_t num_vertices = 0;
+        for( auto const& [ u, v ] : edges )
+        {
+            num_vertices = std::max( num_vertices, std::max( u, v ) + 1 );
+        }
+        std::string header;
+        AppendRaw< std::uint64_t >( header, num_vertices );
+        AppendRaw< std::uint64_t >( header, edges.size() );
+        return WriteInChunks( filePath, edges, []( edge_t const& edge, std::string & buffer )
+        {
+            AppendRaw< std::int32_t >( buffer, edge.first );
+            AppendRaw< std::int32_t >( buffer, edge.second );
+        }, header );
+    }
+
+    return WriteInChunks( filePath, edges, []( edge_t const& edge, std::string & buffer )
+    {
+        AppendNumber( buffer, edge.first );
+        buffer += ',';
+        AppendNumber( buffer, edge.second );
+        buffer += '\n';
+    } );
+}
+
+bool WriteLabels( std::string const& filePath, label_list_t const& labels )
+{
+    if( IsBinaryFile( filePath ) )
+    {
+        std::string header;
+        AppendRaw< std::uint64_t >( header, labels.size() );
+        AppendRaw< std::uint64_t >( header, labels.empty() ? 0 : labels.front().size() );
+        return WriteInChunks( filePath, labels, []( vertex_label_t const& label, std::string & buffer )
+        {
+            for( coordinate_t const coordinate : label )
+            {
+                AppendRaw< std::int32_t >( buffer, coordinate );
+            }
+        }, header );
+    }
+
+    return WriteInChunks( filePath, labels, []( vertex_label_t const& label, std::string & buffer )
+    {
+        for( std::size_t d = 0; d < label.size(); ++d )
+        {
+            if( d > 0 )
+            {
+                buffer += ',';
+            }
+            AppendNumber( buffer, label[ d ] );
+        }
+        buffer += '\n';
+    } );
+}
+
+} // namespace generators
@@ -1,6 +1,12 @@
+#include <algorithm>
+#include <iterator>
+#include <limits>
 #include <queue>
 #include <ranges>
 #include <unordered_map>
+#include <utility>
+
+#include "memory-accounting.hpp"
 
 #include "graph-structural-operations.hpp"
 
@@ -135,6 +141,191 @@ vertex_list_t filter( Container const& input , UnaryPredicate const pred )
 }
 
 
+/**
+ * Removes from an induced neighbourhood, given by position, every edge whose endpoints have fewer than min_common
+ * common neighbours in it, and marks as not alive the vertices whose edge with position 0 was removed. Each triangle
+ * is counted once, from its first vertex in an order by degree, so that no vertex scans more than its out-edges.
+ */
+void RemoveUnsupportedEdges( std::vector< vertex_list_t > & local_edges, vertex_degree_t const min_common, std::vector< char > & is_alive )
+{
+    std::size_t const num_nodes = local_edges.size();
+    auto const Precedes = [ &local_edges ]( std::size_t const u, std::size_t const v )
+    {
+        return std::pair( local_edges[ u ].size(), u ) < std::pair( local_edges[ v ].size(), v );
+    };
+
+    // orient each edge towards the later endpoint; out-edges of u are out_edges[ first_out[ u ], first_out[ u + 1 ] )
+    std::vector< std::size_t > first_out( num_nodes + 1, 0 );
+    vertex_list_t out_edges;
+    for( std::size_t u = 0; u < num_nodes; ++u )
+    {
+        first_out[ u ] = out_edges.size();
+        std::ranges::copy_if( local_edges[ u ], std::back_inserter( out_edges ), [ & ]( std::size_t const v ){ return Precedes( u, v ); } );
+    }
+    first_out[ num_nodes ] = out_edges.size();
+
+    // each triangle u -> v -> w with u -> w adds one to the support of its three edges
+    std::size_t constexpr no_edge = std::numeric_limits< std::size_t >::max();
+    vertex_degree_list_t support( out_edges.size(), 0 );
+    std::vector< std::size_t > edge_from_u( num_nodes, no_edge ); // the out-edge of u to each vertex, while u is processed
+    for( std::size_t u = 0; u < num_nodes; ++u )
+    {
+        for( std::size_t e = first_out[ u ]; e < first_out[ u + 1 ]; ++e )
+        {
+            edge_from_u[ out_edges[ e ] ] = e;
+        }
+        for( std::size_t uv = first_out[ u ]; uv < first_out[ u + 1 ]; ++uv )
+        {
+            vertex_id_t const v = out_edges[ uv ];
+            for( std::size_t vw = first_out[ v ]; vw < first_out[ v + 1 ]; ++vw )
+            {
+                if( std::size_t const uw = edge_from_u[ out_edges[ vw ] ]; uw != no_edge )
+                {
+                    ++support[ uv ];
+                    ++support[ vw ];
+                    ++support[ uw ];
+                }
+            }
+        }
+        for( std::size_t e = first_out[ u ]; e < first_out[ u + 1 ]; ++e )
+        {
+            edge_from_u[ out_edges[ e ] ] = no_edge;
+        }
+    }
+
+    std::vector< vertex_list_t > supported( num_nodes );
+    for( std::size_t u = 0; u < num_nodes; ++u )
+    {
+        for( std::size_t e = first_out[ u ]; e < first_out[ u + 1 ]; ++e )
+        {
+            std::size_t const v = out_edges[ e ];
+            if( support[ e ] >= min_common )
+            {
+                supported[ u ].push_back( v );
+                supported[ v ].push_back( u );
+            }
+            else if( u == 0 || v == 0 )
+            {
+                is_alive[ u == 0 ? v : u ] = false; // cannot share a group with nodes[0]
+            }
+        }
+    }
+    local_edges = std::move( supported );
+}
+
+/**
+ * ReduceToFeasibleCore, optionally also ignoring edges whose endpoints have too few common neighbours in the neighbourhood
+ */
+auto PeelToFeasibleCore( vertex_list_t const& nodes
+                       , adjacency_list_t const& edges
+                       , vertex_degree_t const groupSize
+                       , vertex_degree_t const coreSize
+                       , bool const remove_unsupported_edges ) -> vertex_list_t
+{
+    std::size_t const num_nodes = nodes.size();
+    if( num_nodes < static_cast< std::size_t >( groupSize ) )
+    {
+        return {};
+    }
+
+    vertex_degree_t const min_common = GetMinCommonNeighbours( groupSize, coreSize );
+    auto const Position = [ &nodes ]( vertex_id_t const vertex ) -> std::ptrdiff_t
+    {
+        auto const it = std::lower_bound( std::cbegin( nodes ), std::cend( nodes ), vertex );
+        return it != std::cend( nodes ) && *it == vertex ? it - std::cbegin( nodes ) : -1;
+    };
+
+    // Induce the neighbourhood, by position in nodes.
+    // nodes[0] has the smallest id, so the scan of each descending adjacency list stops there.
+    std::vector< vertex_list_t > local_edges( num_nodes );
+    for( std::size_t i = 0; i < num_nodes; ++i )
+    {
+        vertex_id_t const v = nodes[ i ];
+        for( std::size_t j = 0, n = edges[ v ].size(); j < n && edges[ v ][ j ] >= nodes.front(); ++j )
+        {
+            if( std::ptrdiff_t const position = Position( edges[ v ][ j ] ); position >= 0 )
+            {
+                local_edges[ i ].push_back( position );
+            }
+        }
+    }
+
+    std::vector< char > is_alive( num_nodes, true );
+    if( remove_unsupported_edges )
+    {
+        RemoveUnsupportedEdges( local_edges, min_common, is_alive );
+    }
+
+    std::vector< char > is_adjacent_to_first( num_nodes, false );
+    for( vertex_id_t const position : local_edges.front() )
+    {
+        is_adjacent_to_first[ position ] = true;
+    }
+
+    vertex_degree_list_t degree( num_nodes );
+    vertex_degree_list_t common_with_first( num_nodes, 0 );
+    for( std::size_t i = 0; i < num_nodes; ++i )
+    {
+        degree[ i ] = local_edges[ i ].size();
+        for( vertex_id_t const position : local_edges[ i ] )
+        {
+            common_with_first[ i ] += is_adjacent_to_first[ position ];
+        }
+    }
+
+    auto const IsInfeasible = [ & ]( std::size_t const i )
+    {
+        return degree[ i ] < coreSize
+            || ( i != 0 && common_with_first[ i ] < min_common + ( is_adjacent_to_first[ i ] ? 0 : 2 ) );
+    };
+
+    std::queue< std::size_t > to_remove;
+    for( std::size_t i = 0; i < num_nodes; ++i )
+    {
+        if( ! is_alive[ i ] || IsInfeasible( i ) )
+        {
+            is_alive[ i ] = false;
+            to_remove.push( i );
+        }
+    }
+
+    // Peel, keeping degrees and common neighbours with nodes[0] up to date
+    std::size_t num_alive = num_nodes;
+    while( ! to_remove.empty() )
+    {
+        std::size_t const i = to_remove.front();
+        to_remove.pop();
+        if( i == 0 || --num_alive < static_cast< std::size_t >( groupSize ) )
+        {
+            return {};
+        }
+        for( vertex_id_t const position : local_edges[ i ] )
+        {
+            if( is_alive[ position ] )
+            {
+                --degree[ position ];
+                common_with_first[ position ] -= is_adjacent_to_first[ i ];
+                if( IsInfeasible( position ) )
+                {
+                    is_alive[ position ] = false;
+                    to_remove.push( position );
+                }
+            }
+        }
+    }
+
+    vertex_list_t result;
+    result.reserve( num_alive );
+    for( std::size_t i = 0; i < num_nodes; ++i )
+    {
+        if( is_alive[ i ] )
+        {
+            result.push_back( nodes[ i ] );
+        }
+    }
+    return result;
+}
+
 } // namespace anonymous
 
 auto GetCoreNumbers( adjacency_list_t const& adjacency_vectors ) -> vertex_degree_list_t
@@ -208,13 +399,9 @@ bool IsKCore( vertex_list_t const& vertex_subset, adjacency_list_t const& edges,
 {
     for( vertex_id_t const nodeID : vertex_subset)
     {
-        vertex_list_t const neighbours = GetIntersection( std::crbegin( edges[ nodeID ] )
-        												, std::crend  ( edges[ nodeID ] )
-        												, std::cbegin ( vertex_subset )
-        												, std::cend   ( vertex_subset ) );
         // if there is at least one node with degree
         // less than k then it is not a k-core 
-        if( neighbours.size() < k ) 
+        if( CountNeighboursIn( edges[ nodeID ], vertex_subset ) < k ) 
         {
             return false;
         }
@@ -284,6 +471,7 @@ auto GetKHopNeighbourhood( vertex_id_t u
 
     // initialise breadth-first traversal
     std::vector< bool > visited( remaining, false ); // keep track of nodes with id >= nodeId that are reached
+    memory::ScopedBytes const bytes( memory::Subsystem::neighbourhood, memory::BytesOf( result ) + memory::BytesOf( visited ) );
     std::queue< queue_element > q;
     q.push( { u, 0 } );
     vertex_id_t num_visited = 0;
@@ -325,3 +513,20 @@ auto GetKHopNeighbourhood( vertex_id_t u
 
     return result;
 }
+
+auto ReduceToFeasibleCore( vertex_list_t const& nodes
+                         , adjacency_list_t const& edges
+                         , vertex_degree_t const groupSize
+                         , vertex_degree_t const coreSize ) -> vertex_list_t
+{
+    vertex_list_t const core = PeelToFeasibleCore( nodes, edges, groupSize, coreSize, false );
+
+    // Every group lies within the neighbourhood, so so do the common neighbours that its members need. They are only
+    // counted among the vertices left by the cheaper peel above. The clique kernel intersects the neighbourhoods of
+    // members anyway, so it would not list fewer groups from fewer edges.
+    if( core.empty() || GetMinCommonNeighbours( groupSize, coreSize ) <= 0 || groupSize == coreSize + 1 )
+    {
+        return core;
+    }
+    return PeelToFeasibleCore( core, edges, groupSize, coreSize, true );
+}
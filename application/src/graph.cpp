@@ -1,12 +1,18 @@
 #include <algorithm>
+#include <cctype>
+#include <charconv>
 #include <fstream>
 #include <iostream>
+#include <limits>
 #include <numeric>
+#include <optional>
 #include <ranges>
 #include <sstream>
+#include <stdexcept>
 
 #include "graph-structural-operations.hpp"
 #include "group-skyline-concepts.hpp"
+#include "metrics.hpp"
 #include "sky-layers.hpp"
 
 #include "graph.hpp"
@@ -90,6 +96,132 @@ auto ReorderLabels(myLabelVec& labels, vertex_list_t const& sortedIndices ) -> l
     return sortedLabels;
 }
 
+using edge_buffer_t = std::vector< std::pair< vertex_id_t, vertex_id_t > >;
+
+/**
+ * Calls visit on every line of a stream, reading it in large blocks rather than line by line.
+ * Stops early, returning false, as soon as visit does.
+ */
+template < typename Visitor >
+bool ForEachLine( std::istream & input, Visitor visit )
+{
+    std::size_t constexpr block_size = 1 << 20;
+    std::string buffer;
+    std::size_t begin = 0; // start of the first incomplete line in buffer
+    while( input )
+    {
+        buffer.erase( 0, begin );
+        begin = 0;
+        std::size_t const old_size = buffer.size();
+        buffer.resize( old_size + block_size );
+        input.read( buffer.data() + old_size, block_size );
+        buffer.resize( old_size + input.gcount() );
+
+        for( std::size_t end; ( end = buffer.find( '\n', begin ) ) != std::string::npos; begin = end + 1 )
+        {
+            if( ! visit( std::string_view( buffer ).substr( begin, end - begin ) ) )
+            {
+                return false;
+            }
+        }
+    }
+    return begin == buffer.size() || visit( std::string_view( buffer ).substr( begin ) );
+}
+
+/**
+ * Parses the next integer in [first, last), skipping leading separators (commas and whitespace).
+ * Returns the position after it, or nullptr if there is none.
+ */
+template < typename Integer >
+auto ParseInteger( char const* first, char const* const last, Integer & value ) -> char const*
+{
+    while( first != last && ( *first == ',' || std::isspace( static_cast< unsigned char >( *first ) ) ) )
+    {
+        ++first;
+    }
+    auto const [ position, error ] = std::from_chars( first, last, value );
+    return error == std::errc{} ? position : nullptr;
+}
+
+/**
+ * Reads count values of raw binary data; false if the stream ends first
+ */
+template < typename T >
+bool ReadBinary( std::istream & input, T * values, std::size_t const count )
+{
+    return static_cast< bool >( input.read( reinterpret_cast< char * >( values ), count * sizeof( T ) ) );
+}
+
+template < typename T >
+bool ReadBinary( std::istream & input, std::vector< T > & values, std::size_t const count )
+{
+    values.resize( count );
+    return ReadBinary( input, values.data(), count );
+}
+
+/**
+ * The number of values of type T in the body of a binary file, i.e., rows * columns as given by its header.
+ * Throws if that product overflows or the rest of the file does not hold exactly that many values, so that
+ * a truncated or corrupt header never sizes a buffer.
+ */
+template < typename T >
+auto BinaryBodySize( std::istream & input, std::uint64_t const rows, std::uint64_t const columns, std::string const& filePath ) -> std::size_t
+{
+    if( columns != 0 && rows > std::numeric_limits< std::size_t >::max() / sizeof( T ) / columns )
+    {
+        throw std::runtime_error( "the header of " + filePath + " gives " + std::to_string( rows ) + " x "
+                                + std::to_string( columns ) + " values, more than can be addressed" );
+    }
+    std::size_t const count = rows * columns;
+
+    auto const body = input.tellg();
+    input.seekg( 0, std::ios::end );
+    auto const end = input.tellg();
+    input.seekg( body );
+    if( body < 0 || end < 0 || static_cast< std::uint64_t >( end - body ) != count * sizeof( T ) )
+    {
+        throw std::runtime_error( "the header of " + filePath + " gives " + std::to_string( count ) + " values of "
+                                + std::to_string( sizeof( T ) ) + " bytes, but " + std::to_string( end - body )
+                                + " bytes follow it" );
+    }
+    return count;
+}
+
+/**
+ * Builds ascending adjacency lists of exactly the required capacity; edges with an endpoint
+ * outside [0, num_vertices) are dropped
+ */
+auto ToAdjacencyList( edge_buffer_t const& buffer, vertex_id_t const num_vertices ) -> adjacency_list_t
+{
+    auto const IsValid = [ num_vertices ]( auto const& edge )
+    {
+        return edge.first < num_vertices && edge.second < num_vertices;
+    };
+
+    vertex_degree_list_t degrees( num_vertices, 0 );
+    for( auto const& edge : buffer | std::views::filter( IsValid ) )
+    {
+        ++degrees[ edge.first ];
+        ++degrees[ edge.second ];
+    }
+
+    adjacency_list_t edges( num_vertices );
+    for( vertex_id_t const v : std::views::iota( 0, num_vertices ) )
+    {
+        edges[ v ].reserve( degrees[ v ] );
+    }
+    for( auto const& [ u, v ] : buffer | std::views::filter( IsValid ) )
+    {
+        edges[ u ].push_back( v );
+        edges[ v ].push_back( u );
+    }
+    for( auto & neighbours : edges )
+    {
+        std::sort( std::begin( neighbours ), std::end( neighbours ) );
+    }
+    return edges;
+}
+
 } // namespace anonymous
 
 
@@ -123,72 +255,189 @@ auto BinSortByDegree( adjacency_list_t const& edges ) -> std::tuple< vertex_list
     return std::make_tuple( sortedIndices, nodePosition, binBoundaries );
 }
 
-bool LoadEdges (const std::string& filePath, intVec2D& edges, int nodeSize)
+bool IsBinaryFile( std::string const& filePath )
+{
+    return filePath.ends_with( ".bin" );
+}
+
+bool LoadEdges( std::string const& filePath, adjacency_list_t & edges, std::optional< vertex_id_t > nodeSize )
 {
-    std::ifstream inputFile(filePath);
-    if (!inputFile.is_open()) {
-        std::cout << "Could not open the file...\n";
+    metrics::ScopedPhase phase( metrics::Phase::load );
+    std::ifstream inputFile( filePath, std::ios::binary );
+    if( ! inputFile.is_open() )
+    {
+        std::cout << "Could not open the file " << filePath << "...\n";
         return false;
     }
 
-    edges.clear();
-    edges.resize(nodeSize);
-
-    std::vector<std::string> row;
-    std::string line, word;
-    while (getline(inputFile, line))
+    edge_buffer_t buffer;
+    vertex_id_t num_vertices = 0;
+    if( IsBinaryFile( filePath ) )
     {
-        row.clear();
-        std::stringstream ss(line);
-        while (getline(ss, word, ',')) 
+        std::uint64_t header[ 2 ]; // number of vertices and of edges
+        std::vector< std::int32_t > endpoints;
+        if( ! ReadBinary( inputFile, header, 2 ) )
+        {
+            std::cout << "Truncated binary edge file " << filePath << "...\n";
+            return false;
+        }
+        if( header[ 0 ] > static_cast< std::uint64_t >( std::numeric_limits< vertex_id_t >::max() ) )
+        {
+            throw std::runtime_error( "the header of " + filePath + " gives " + std::to_string( header[ 0 ] ) + " vertices, more than vertex ids can name" );
+        }
+        if( ! ReadBinary( inputFile, endpoints, BinaryBodySize< std::int32_t >( inputFile, header[ 1 ], 2, filePath ) ) )
         {
-            row.push_back(word);
+            std::cout << "Truncated binary edge file " << filePath << "...\n";
+            return false;
         }
-        int u = std::stoi(row[0]);
-        int v = std::stoi(row[1]);
-        if (u < nodeSize && v < nodeSize){
-            edges[u].push_back(v);
-            edges[v].push_back(u);
+        num_vertices = header[ 0 ];
+        buffer.reserve( header[ 1 ] );
+        for( std::size_t i = 0; i < endpoints.size(); i += 2 )
+        {
+            buffer.emplace_back( endpoints[ i ], endpoints[ i + 1 ] );
+        }
+    }
+    else
+    {
+        std::size_t line_number = 0;
+        bool const parsed = ForEachLine( inputFile, [ & ]( std::string_view const line )
+        {
+            ++line_number;
+            if( line.find_first_not_of( " \t\r" ) == std::string_view::npos )
+            {
+                return true;
+            }
+            vertex_id_t u, v;
+            char const* position = ParseInteger( line.data(), line.data() + line.size(), u );
+            position = position == nullptr ? nullptr : ParseInteger( position, line.data() + line.size(), v );
+            if( position == nullptr )
+            {
+                std::cout << "Malformed edge on line " << line_number << " of " << filePath << "...\n";
+                return false;
+            }
+            buffer.emplace_back( u, v );
+            return true;
+        } );
+        if( ! parsed )
+        {
+            return false;
         }
     }
-    inputFile.close();
 
-    for (auto& vec: edges) 
+    for( auto const& [ u, v ] : buffer )
+    {
+        if( u < 0 || v < 0 )
+        {
+            std::cout << "Negative vertex id in " << filePath << "...\n";
+            return false;
+        }
+        num_vertices = std::max( num_vertices, std::max( u, v ) + 1 );
+    }
+    if( nodeSize ) // edges past the given vertex count are dropped
     {
-        std::sort(vec.begin(), vec.end());
+        num_vertices = *nodeSize;
     }
+
+    edges = ToAdjacencyList( buffer, num_vertices );
     return true;
 }
 
-bool LoadLabels(const std::string& filePath, myLabelVec& labels, int nodeSize)
+bool LoadLabels( std::string const& filePath, label_list_t & labels, std::optional< vertex_id_t > nodeSize )
 {
-    std::ifstream inputFile(filePath);
-    if (!inputFile.is_open()) {
-        std::cout << "Could not open the file...\n";
+    metrics::ScopedPhase phase( metrics::Phase::load );
+    std::ifstream inputFile( filePath, std::ios::binary );
+    if( ! inputFile.is_open() )
+    {
+        std::cout << "Could not open the file " << filePath << "...\n";
         return false;
     }
 
     labels.clear();
-    labels.resize(nodeSize);
-
-    std::string line, word;
-    int i = 0;
-    while (getline(inputFile, line))
+    if( IsBinaryFile( filePath ) )
     {
-        if (i == nodeSize)
+        std::uint64_t header[ 2 ]; // number of vertices and dimensions
+        std::vector< std::int32_t > coordinates;
+        if( ! ReadBinary( inputFile, header, 2 ) || ! ReadBinary( inputFile, coordinates, BinaryBodySize< std::int32_t >( inputFile, header[ 0 ], header[ 1 ], filePath ) ) )
         {
-            break;
+            std::cout << "Truncated binary label file " << filePath << "...\n";
+            return false;
         }
-
-        myLabel row;
-        std::stringstream ss(line);
-        while (getline(ss, word, ','))
+        std::size_t const num_vertices = nodeSize ? std::min< std::size_t >( *nodeSize, header[ 0 ] ) : header[ 0 ];
+        labels.reserve( nodeSize ? *nodeSize : num_vertices );
+        for( std::size_t i = 0; i < num_vertices; ++i )
+        {
+            labels.emplace_back( coordinates.cbegin() + i * header[ 1 ], coordinates.cbegin() + ( i + 1 ) * header[ 1 ] );
+        }
+    }
+    else
+    {
+        if( nodeSize )
+        {
+            labels.reserve( *nodeSize );
+        }
+        std::size_t num_dimensions = 0; // of the first label; all others must match
+        bool malformed = false;
+        ForEachLine( inputFile, [ & ]( std::string_view const line )
+        {
+            if( nodeSize && labels.size() == static_cast< std::size_t >( *nodeSize ) )
+            {
+                return false;
+            }
+            if( line.find_first_not_of( " \t\r" ) == std::string_view::npos )
+            {
+                return true;
+            }
+            vertex_label_t label;
+            label.reserve( num_dimensions );
+            char const* position = line.data();
+            char const* const end = line.data() + line.size();
+            coordinate_t coordinate;
+            while( ( position = ParseInteger( position, end, coordinate ) ) != nullptr )
+            {
+                label.push_back( coordinate );
+            }
+            if( labels.empty() )
+            {
+                num_dimensions = label.size();
+            }
+            if( label.size() != num_dimensions )
+            {
+                std::cout << "Label " << labels.size() << " of " << filePath << " has " << label.size()
+                          << " coordinates; expected " << num_dimensions << "...\n";
+                malformed = true;
+                return false;
+            }
+            labels.push_back( std::move( label ) );
+            return true;
+        } );
+        if( malformed )
         {
-            row.push_back( std::stoi( word ) ); //vector
+            labels.clear();
+            return false;
         }
-        labels[i++] = row;
     }
-    inputFile.close();
+
+    if( nodeSize && labels.size() < static_cast< std::size_t >( *nodeSize ) )
+    {
+        std::cout << filePath << " holds " << labels.size() << " labels; expected " << *nodeSize << "...\n";
+        labels.clear();
+        return false;
+    }
+    return true;
+}
+
+bool LoadGraph( std::string const& edgesFilePath, std::string const& labelsFilePath, Graph & graph, std::optional< vertex_id_t > nodeSize )
+{
+    if( ! LoadEdges( edgesFilePath, graph.edges, nodeSize ) )
+    {
+        return false;
+    }
+    // the vertex count comes from the edges, so that labels beyond it (e.g., in shared label files) are never read
+    if( ! LoadLabels( labelsFilePath, graph.labels, static_cast< vertex_id_t >( graph.edges.size() ) ) )
+    {
+        return false;
+    }
+    graph.size = graph.labels.size();
     return true;
 }
 
@@ -201,15 +450,24 @@ void UpdateGraph (Graph& myGraph)
     myGraph.size = n;
     
     PointList sorted_points;
-    std::tie(myGraph.toOriginal, sorted_points) = OrderByPartition( labels );
+    {
+        metrics::ScopedPhase phase( metrics::Phase::partition );
+        std::tie(myGraph.toOriginal, sorted_points) = OrderByPartition( labels );
 
-    labels = ReorderLabels( labels, myGraph.toOriginal );
-    myGraph.toRelabelled = InvertMapping( myGraph.toOriginal );
+        labels = ReorderLabels( labels, myGraph.toOriginal );
+        myGraph.toRelabelled = InvertMapping( myGraph.toOriginal );
+
+        edges = TransformEdgeLists( edges, myGraph.toOriginal, myGraph.toRelabelled, true );
+    }
 
-    edges = TransformEdgeLists( edges, myGraph.toOriginal, myGraph.toRelabelled, true );
+    // the preprocessed graph is charged for the lifetime of the process; sky layers only while they are built
+    memory::Add( memory::Subsystem::graph, memory::BytesOf( edges ) + memory::BytesOf( myGraph.toOriginal ) + memory::BytesOf( myGraph.toRelabelled ) );
+    memory::Add( memory::Subsystem::labels, memory::BytesOf( labels ) );
 
+    metrics::ScopedPhase phase( metrics::Phase::sky_layers );
     auto skyLayers = GenerateSkyLayers( sorted_points );
     size_t const num_layers = skyLayers.size();
+    memory::ScopedBytes const skyLayerBytes( memory::Subsystem::sky_layers, memory::BytesOf( skyLayers ) );
     
     // Starting position of points in layers
     myGraph.skyLayersBoundaries.resize(num_layers + 1);
@@ -225,4 +483,5 @@ void UpdateGraph (Graph& myGraph)
         std::iota(layerNodes.begin(), layerNodes.end(), myGraph.skyLayersBoundaries[i]);
         myGraph.layerRepresentatives[i] = GetBestVirtualPoint(layerNodes, labels);
     }
+    memory::Add( memory::Subsystem::sky_layers, memory::BytesOf( myGraph.skyLayersBoundaries ) + memory::BytesOf( myGraph.layerRepresentatives ) );
 }
@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+#include "group-store.hpp"
+
+void GroupStore::reserve( std::size_t const numGroups )
+{
+    m_members.reserve( numGroups * m_group_size );
+    m_worst.reserve( numGroups * m_num_dimensions );
+    m_best.reserve( numGroups * m_num_dimensions );
+}
+
+void GroupStore::clear()
+{
+    m_members.clear();
+    m_worst.clear();
+    m_best.clear();
+    m_num_groups = 0;
+}
+
+void GroupStore::Append( group_view_t const group, label_list_t const& labels )
+{
+    assert( "All groups in a store have the same size" && group.size() == m_group_size );
+
+    m_members.insert( std::end( m_members ), std::cbegin( group ), std::cend( group ) );
+    m_worst.insert( std::end( m_worst ), m_num_dimensions, std::numeric_limits< coordinate_t >::lowest() );
+    m_best.insert( std::end( m_best ), m_num_dimensions, std::numeric_limits< coordinate_t >::max() );
+
+    auto const worst = std::end( m_worst ) - m_num_dimensions;
+    auto const best  = std::end( m_best ) - m_num_dimensions;
+    for( point_index_t const member : group )
+    {
+        auto const& label = labels[ member ];
+        for( std::size_t d = 0; d < m_num_dimensions; ++d )
+        {
+            worst[ d ] = std::max( worst[ d ], label[ d ] );
+            best[ d ]  = std::min( best[ d ], label[ d ] );
+        }
+    }
+    ++m_num_groups;
+}
+
+void GroupStore::Append( GroupStore const& groups, std::size_t const i )
+{
+    assert( groups.m_group_size == m_group_size && groups.m_num_dimensions == m_num_dimensions );
+
+    auto const members = groups[ i ];
+    auto const worst = groups.Worst( i );
+    auto const best = groups.Best( i );
+    m_members.insert( std::end( m_members ), std::cbegin( members ), std::cend( members ) );
+    m_worst.insert( std::end( m_worst ), std::cbegin( worst ), std::cend( worst ) );
+    m_best.insert( std::end( m_best ), std::cbegin( best ), std::cend( best ) );
+    ++m_num_groups;
+}
+
+void GroupStore::Resize( std::size_t const numGroups )
+{
+    m_members.resize( numGroups * m_group_size );
+    m_worst.resize( numGroups * m_num_dimensions );
+    m_best.resize( numGroups * m_num_dimensions );
+    m_num_groups = numGroups;
+}
+
+void GroupStore::Place( std::size_t const position, GroupStore const& groups )
+{
+    assert( groups.m_group_size == m_group_size && groups.m_num_dimensions == m_num_dimensions );
+    assert( position + groups.size() <= size() );
+
+    std::copy( std::cbegin( groups.m_members ), std::cend( groups.m_members ), std::begin( m_members ) + position * m_group_size );
+    std::copy( std::cbegin( groups.m_worst ), std::cend( groups.m_worst ), std::begin( m_worst ) + position * m_num_dimensions );
+    std::copy( std::cbegin( groups.m_best ), std::cend( groups.m_best ), std::begin( m_best ) + position * m_num_dimensions );
+}
+
+void GroupStore::Compact( std::vector< bool > const& keep )
+{
+    assert( keep.size() == m_num_groups );
+
+    // Two pointer algorithm as in postprocess: everything before destination has been kept
+    std::size_t destination = 0;
+    for( std::size_t source = 0; source < m_num_groups; ++source )
+    {
+        if( keep[ source ] )
+        {
+            if( destination != source ) // skip unnecessary copy if source == destination
+            {
+                std::copy_n( std::cbegin( m_members ) + source * m_group_size, m_group_size, std::begin( m_members ) + destination * m_group_size );
+                std::copy_n( std::cbegin( m_worst ) + source * m_num_dimensions, m_num_dimensions, std::begin( m_worst ) + destination * m_num_dimensions );
+                std::copy_n( std::cbegin( m_best ) + source * m_num_dimensions, m_num_dimensions, std::begin( m_best ) + destination * m_num_dimensions );
+            }
+            ++destination;
+        }
+    }
+    Resize( destination );
+}
+
+auto GroupStore::ToGroupList() const -> std::vector< index_list_t >
+{
+    std::vector< index_list_t > groups;
+    groups.reserve( m_num_groups );
+    for( auto const group : *this )
+    {
+        groups.emplace_back( std::cbegin( group ), std::cend( group ) );
+    }
+    return groups;
+}
+
+auto GroupStore::GetCapacityBytes() const -> std::int64_t
+{
+    return ( m_members.capacity() * sizeof( point_index_t ) )
+         + ( m_worst.capacity() + m_best.capacity() ) * sizeof( coordinate_t );
+}
@@ -0,0 +1,232 @@
+#include <algorithm>
+#include <bit>
+#include <iterator>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include "intersection.hpp"
+
+namespace { // anonymous
+
+/**
+ * Lists whose sizes differ by at least this factor are intersected by galloping through the longer one
+ */
+constexpr std::size_t galloping_ratio = 32;
+
+/**
+ * Number of vertices compared at once by the block merge
+ */
+constexpr std::size_t block_size = 8;
+
+/**
+ * Writes each vertex of the intersection to consecutive positions of a buffer. Every vertex is written no later
+ * than it is read from the second list and to a position no greater than its own, so the buffer may be that list.
+ */
+struct Writer
+{
+    vertex_id_t * out;
+    std::size_t size = 0;
+
+    void operator () ( vertex_id_t const vertex ) { out[ size++ ] = vertex; }
+};
+
+/**
+ * Counts the vertices of the intersection
+ */
+struct Counter
+{
+    std::size_t size = 0;
+
+    void operator () ( vertex_id_t ) { ++size; }
+};
+
+/**
+ * The first list of an intersection, viewed in ascending order whether it is stored ascending or descending
+ */
+template < bool Descending >
+struct AscendingView
+{
+    vertex_id_t const* data;
+    std::size_t size;
+
+    auto operator [] ( std::size_t const i ) const -> vertex_id_t { return Descending ? data[ size - 1 - i ] : data[ i ]; }
+
+    auto begin() const
+    {
+        if constexpr( Descending ) { return std::make_reverse_iterator( data + size ); }
+        else                       { return data; }
+    }
+};
+
+/**
+ * First position at or after first whose vertex is not smaller than vertex, found by doubling the step and
+ * then binary searching within the last step, so that it costs logarithmically in the distance travelled
+ */
+template < typename RandomIterator >
+auto GallopTo( RandomIterator first, RandomIterator const last, vertex_id_t const vertex ) -> RandomIterator
+{
+    std::ptrdiff_t step = 1;
+    std::ptrdiff_t const remaining = last - first;
+    while( step < remaining && first[ step ] < vertex )
+    {
+        step *= 2;
+    }
+    return std::lower_bound( first + step / 2, first + std::min( step + 1, remaining ), vertex );
+}
+
+template < bool Descending, typename Sink >
+void Merge( AscendingView< Descending > const a, std::size_t i, sorted_view_t const b, std::size_t j, Sink & sink )
+{
+    while( i < a.size && j < b.size() )
+    {
+        vertex_id_t const vertex = b[ j ];
+        if     ( a[ i ] < vertex ) { ++i; }
+        else if( vertex < a[ i ] ) { ++j; }
+        else
+        {
+            sink( vertex );
+            ++i;
+            ++j;
+        }
+    }
+}
+
+template < bool Descending, typename Sink >
+void Gallop( AscendingView< Descending > const a, sorted_view_t const b, Sink & sink )
+{
+    if( a.size <= b.size() )
+    {
+        auto it_b = std::cbegin( b );
+        for( std::size_t i = 0; i < a.size && it_b != std::cend( b ); ++i )
+        {
+            it_b = GallopTo( it_b, std::cend( b ), a[ i ] );
+            if( it_b != std::cend( b ) && *it_b == a[ i ] )
+            {
+                sink( *it_b++ );
+            }
+        }
+    }
+    else
+    {
+        auto it_a = a.begin();
+        auto const end_a = a.begin() + a.size;
+        for( std::size_t j = 0; j < b.size() && it_a != end_a; ++j )
+        {
+            vertex_id_t const vertex = b[ j ];
+            it_a = GallopTo( it_a, end_a, vertex );
+            if( it_a != end_a && *it_a == vertex )
+            {
+                sink( vertex );
+                ++it_a;
+            }
+        }
+    }
+}
+
+template < bool Descending, typename Sink >
+void BlockMerge( AscendingView< Descending > const a, sorted_view_t const b, Sink & sink )
+{
+    std::size_t i = 0;
+    std::size_t j = 0;
+#ifdef __AVX2__
+    // Compares a block of b against all eight rotations of a block of a; blocks of a are loaded as stored,
+    // since the order within a block does not matter for which vertices of b it contains
+    __m256i const rotate = _mm256_set_epi32( 0, 7, 6, 5, 4, 3, 2, 1 );
+    while( i + block_size <= a.size && j + block_size <= b.size() )
+    {
+        vertex_id_t const* const block_a = Descending ? a.data + a.size - block_size - i : a.data + i;
+        __m256i block = _mm256_loadu_si256( reinterpret_cast< __m256i const* >( block_a ) );
+        __m256i const block_b = _mm256_loadu_si256( reinterpret_cast< __m256i const* >( b.data() + j ) );
+        __m256i matches = _mm256_cmpeq_epi32( block_b, block );
+        for( std::size_t r = 1; r < block_size; ++r )
+        {
+            block = _mm256_permutevar8x32_epi32( block, rotate );
+            matches = _mm256_or_si256( matches, _mm256_cmpeq_epi32( block_b, block ) );
+        }
+
+        vertex_id_t const last_a = a[ i + block_size - 1 ];
+        vertex_id_t const last_b = b[ j + block_size - 1 ];
+        for( unsigned mask = _mm256_movemask_ps( _mm256_castsi256_ps( matches ) ); mask != 0; mask &= mask - 1 )
+        {
+            sink( b[ j + std::countr_zero( mask ) ] );
+        }
+        // every vertex of b that matches a vertex of a block of a lies in the block of b being compared, or a later one
+        if( last_a <= last_b ) { i += block_size; }
+        if( last_b <= last_a ) { j += block_size; }
+    }
+#endif
+    Merge( a, i, b, j, sink );
+}
+
+template < bool Descending, typename Sink >
+void Intersect( AscendingView< Descending > const a, sorted_view_t const b, IntersectionKernel const kernel, Sink & sink )
+{
+    switch( kernel )
+    {
+        case IntersectionKernel::merge:       Merge( a, 0, b, 0, sink ); break;
+        case IntersectionKernel::block_merge: BlockMerge( a, b, sink ); break;
+        case IntersectionKernel::galloping:   Gallop( a, b, sink ); break;
+    }
+}
+
+template < bool Descending >
+void IntersectInto( AscendingView< Descending > const a, sorted_view_t const b, IntersectionKernel const kernel, vertex_list_t & result )
+{
+    if( result.data() != b.data() ) // else result already holds b, and is at least as long as the intersection
+    {
+        result.resize( std::min( a.size, b.size() ) );
+    }
+    Writer writer{ result.data() };
+    Intersect( a, b, kernel, writer );
+    result.resize( writer.size );
+}
+
+template < bool Descending >
+auto CountIn( AscendingView< Descending > const a, sorted_view_t const b ) -> std::size_t
+{
+    Counter counter;
+    Intersect( a, b, ChooseIntersectionKernel( a.size, b.size() ), counter );
+    return counter.size;
+}
+
+} // namespace anonymous
+
+
+auto ChooseIntersectionKernel( std::size_t const size1, std::size_t const size2 ) -> IntersectionKernel
+{
+    std::size_t const shorter = std::min( size1, size2 );
+    std::size_t const longer  = std::max( size1, size2 );
+    if( shorter > 0 && longer / shorter >= galloping_ratio )
+    {
+        return IntersectionKernel::galloping;
+    }
+#ifdef __AVX2__
+    if( shorter >= block_size )
+    {
+        return IntersectionKernel::block_merge;
+    }
+#endif
+    return IntersectionKernel::merge;
+}
+
+void GetIntersection( sorted_view_t const group1, sorted_view_t const group2, vertex_list_t & result, IntersectionKernel const kernel )
+{
+    IntersectInto( AscendingView< false >{ group1.data(), group1.size() }, group2, kernel, result );
+}
+
+auto CountIntersection( sorted_view_t const group1, sorted_view_t const group2 ) -> std::size_t
+{
+    return CountIn( AscendingView< false >{ group1.data(), group1.size() }, group2 );
+}
+
+void GetNeighboursIn( vertex_list_t const& neighbours, sorted_view_t const group, vertex_list_t & result )
+{
+    IntersectInto( AscendingView< true >{ neighbours.data(), neighbours.size() }, group, ChooseIntersectionKernel( neighbours.size(), group.size() ), result );
+}
+
+auto CountNeighboursIn( vertex_list_t const& neighbours, sorted_view_t const group ) -> std::size_t
+{
+    return CountIn( AscendingView< true >{ neighbours.data(), neighbours.size() }, group );
+}
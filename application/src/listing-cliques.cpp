@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+#include "listing-cousins-first.hpp"
+
+#include "listing-cliques.hpp"
+
+namespace { // anonymous
+
+using word_t = std::uint64_t;
+constexpr std::size_t bits_per_word = 64;
+
+/**
+ * Neighbourhoods above this size would need a prohibitively large bitset matrix; they are listed generically
+ */
+constexpr std::size_t max_bitset_vertices = 8192;
+
+/**
+ * Each thread's storage for the bitsets and the candidate levels of the neighbourhood it lists. It only grows, so
+ * a thread allocates for its largest neighbourhood once, and each neighbourhood clears only the words it uses.
+ */
+thread_local std::vector< word_t > t_rows;
+thread_local std::vector< word_t > t_levels;
+
+/**
+ * A neighbourhood of nodes[0] as a directed acyclic graph from each vertex to its neighbours with larger ids,
+ * stored as one row of words per vertex in which bit j is set if the vertex points to nodes[j]. The rows live
+ * in the given storage, which must outlive this.
+ */
+class OutNeighbourBitsets
+{
+public:
+
+    OutNeighbourBitsets( vertex_list_t const& nodes, adjacency_list_t const& edges, std::vector< word_t > & storage )
+        : m_num_words( ( nodes.size() + bits_per_word - 1 ) / bits_per_word )
+    {
+        storage.assign( nodes.size() * m_num_words, 0 ); // reuses the capacity of earlier neighbourhoods
+        m_rows = storage.data();
+
+        for( std::size_t i = 0, n = nodes.size(); i < n; ++i )
+        {
+            // merge the ascending tail of nodes with the neighbours, walking the descending list from its back
+            vertex_list_t const& neighbours = edges[ nodes[ i ] ];
+            auto it_neighbour = std::crbegin( neighbours );
+            std::size_t j = i + 1;
+            while( it_neighbour != std::crend( neighbours ) && j < n )
+            {
+                if     ( *it_neighbour < nodes[ j ] ) { ++it_neighbour; }
+                else if( nodes[ j ] < *it_neighbour ) { ++j; }
+                else
+                {
+                    m_rows[ i * m_num_words + j / bits_per_word ] |= word_t{ 1 } << ( j % bits_per_word );
+                    ++it_neighbour;
+                    ++j;
+                }
+            }
+        }
+    }
+
+    auto GetNumWords() const -> std::size_t { return m_num_words; }
+    auto Row( std::size_t i ) const -> word_t const* { return m_rows + i * m_num_words; }
+
+private:
+
+    std::size_t m_num_words;
+    word_t * m_rows = nullptr;
+};
+
+/**
+ * Extends clique by one vertex of candidates at a time, in ascending order, and appends every clique of
+ * cliqueSize vertices to the store. candidates points into levels, which has one row of candidates per
+ * level of the recursion below this one, and holds numCandidates set bits.
+ */
+void ListCliquesRecursive( OutNeighbourBitsets const& dag
+                         , vertex_list_t const& nodes
+                         , word_t const* candidates
+                         , std::size_t numCandidates
+                         , word_t * levels
+                         , group_t & clique
+                         , std::size_t cliqueSize
+                         , label_list_t const& labels
+                         , GroupStore & cliques )
+{
+    std::size_t const num_words = dag.GetNumWords();
+    std::size_t const num_missing = cliqueSize - clique.size();
+
+    for( std::size_t w = 0; w < num_words; ++w )
+    {
+        for( word_t bits = candidates[ w ]; bits != 0; bits &= bits - 1 )
+        {
+            // later candidates alone cannot complete the clique
+            if( numCandidates-- < num_missing )
+            {
+                return;
+            }
+
+            std::size_t const position = w * bits_per_word + std::countr_zero( bits );
+            clique.push_back( nodes[ position ] );
+            if( num_missing == 1 )
+            {
+                cliques.Append( clique, labels );
+            }
+            else
+            {
+                // all out-neighbours lie at larger positions, so words before w are empty
+                word_t const* const out_neighbours = dag.Row( position );
+                std::size_t num_next = 0;
+                for( std::size_t v = w; v < num_words; ++v )
+                {
+                    levels[ v ] = candidates[ v ] & out_neighbours[ v ];
+                    num_next += std::popcount( levels[ v ] );
+                }
+                if( num_next >= num_missing - 1 )
+                {
+                    std::fill( levels, levels + w, 0 );
+                    ListCliquesRecursive( dag, nodes, levels, num_next, levels + num_words, clique, cliqueSize, labels, cliques );
+                }
+            }
+            clique.pop_back();
+        }
+    }
+}
+
+} // namespace anonymous
+
+
+namespace base {
+namespace listing {
+namespace cliques {
+
+void ListCliquesWithPrefix( vertex_list_t const& nodes, adjacency_list_t const& edges, int cliqueSize, label_list_t const& labels, GroupStore & cliques )
+{
+    std::size_t const clique_size = cliqueSize;
+    if( nodes.size() < clique_size )
+    {
+        return;
+    }
+    if( nodes.size() > max_bitset_vertices )
+    {
+        cousins_first::ListKCoresWithPrefix( nodes, edges, cliqueSize, cliqueSize - 1, labels, cliques );
+        return;
+    }
+
+    OutNeighbourBitsets const dag( nodes, edges, t_rows );
+    std::size_t const num_words = dag.GetNumWords();
+    std::vector< word_t > & levels = t_levels; // the candidates of each level of the recursion
+    levels.assign( clique_size * num_words, 0 );
+
+    std::size_t num_candidates = 0;
+    for( std::size_t w = 0; w < num_words; ++w )
+    {
+        levels[ w ] = dag.Row( 0 )[ w ];
+        num_candidates += std::popcount( levels[ w ] );
+    }
+
+    group_t clique = { nodes.front() };
+    clique.reserve( clique_size );
+    if( clique_size == 1 )
+    {
+        cliques.Append( clique, labels );
+    }
+    else if( num_candidates >= clique_size - 1 )
+    {
+        ListCliquesRecursive( dag, nodes, levels.data(), num_candidates, levels.data() + num_words, clique, clique_size, labels, cliques );
+    }
+}
+
+} // namespace cliques
+} // namespace listing
+} // namespace base
@@ -1,7 +1,10 @@
+#include <algorithm>
 #include <iostream>
+#include <numeric>
 #include <ranges>
 
 #include "graph-structural-operations.hpp"
+#include "metrics.hpp"
 
 #include "listing-cousins-first.hpp"
 
@@ -19,6 +22,92 @@ struct GroupInfo
     using TailsetIterator = decltype( std::cbegin( tailset ) );
 };
 
+/**
+ * A greedy colouring of the subgraph induced by a neighbourhood, computed once per prefix and shared by the
+ * whole recursion. Vertices of one colour are pairwise non-adjacent, so a group in which every vertex misses at
+ * most maxMissedConnections others holds at most maxMissedConnections + 1 of them; summed over all colours,
+ * this bounds how far a group can still grow from a tailset (cf. the partition bounds of maximum k-plex solvers).
+ * An empty colouring bounds nothing.
+ */
+class Colouring
+{
+public:
+
+    Colouring() = default;
+
+    /**
+     * Colours nodes, highest degree in the induced subgraph first, each with the smallest colour not taken by a neighbour
+     * @pre nodes are sorted in ascending order and neighbours in descending order
+     */
+    Colouring( vertex_list_t const& nodes, adjacency_list_t const& edges )
+        : m_nodes( &nodes )
+        , m_colours( nodes.size(), -1 )
+    {
+        std::size_t const num_nodes = nodes.size();
+        std::vector< vertex_list_t > local_edges( num_nodes ); // by position in nodes
+        vertex_list_t neighbours;
+        for( std::size_t i = 0; i < num_nodes; ++i )
+        {
+            GetNeighboursIn( edges[ nodes[ i ] ], nodes, neighbours );
+            for( vertex_id_t const neighbour : neighbours )
+            {
+                local_edges[ i ].push_back( GetPosition( neighbour ) );
+            }
+        }
+
+        vertex_list_t order( num_nodes );
+        std::iota( std::begin( order ), std::end( order ), 0 );
+        std::stable_sort( std::begin( order ), std::end( order ), [ &local_edges ]( auto const a, auto const b )
+        {
+            return local_edges[ a ].size() > local_edges[ b ].size();
+        } );
+
+        std::vector< char > is_taken;
+        for( vertex_id_t const i : order )
+        {
+            is_taken.assign( m_num_colours + 1, false );
+            for( vertex_id_t const neighbour : local_edges[ i ] )
+            {
+                if( m_colours[ neighbour ] >= 0 )
+                {
+                    is_taken[ m_colours[ neighbour ] ] = true;
+                }
+            }
+            m_colours[ i ] = std::distance( std::cbegin( is_taken ), std::find( std::cbegin( is_taken ), std::cend( is_taken ), false ) );
+            m_num_colours = std::max( m_num_colours, m_colours[ i ] + 1 );
+        }
+    }
+
+    bool IsEmpty() const { return m_nodes == nullptr; }
+
+    /**
+     * Writes to bounds[i] the largest number of vertices of tailset[i..] that a group missing at most
+     * maxMissedConnections connections per vertex could contain, so bounds[0] covers the whole tailset
+     * @pre tailset is a subset of the coloured nodes
+     */
+    void GetSuffixBounds( vertex_list_t const& tailset, int maxMissedConnections, std::vector< int > & bounds ) const
+    {
+        std::vector< int > per_colour( m_num_colours, 0 );
+        bounds.assign( tailset.size() + 1, 0 );
+        for( std::size_t i = tailset.size(); i-- > 0; )
+        {
+            bool const fits = ++per_colour[ m_colours[ GetPosition( tailset[ i ] ) ] ] <= maxMissedConnections + 1;
+            bounds[ i ] = bounds[ i + 1 ] + ( fits ? 1 : 0 );
+        }
+    }
+
+private:
+
+    auto GetPosition( vertex_id_t const vertex ) const -> std::size_t
+    {
+        return std::lower_bound( std::cbegin( *m_nodes ), std::cend( *m_nodes ), vertex ) - std::cbegin( *m_nodes );
+    }
+
+    vertex_list_t const* m_nodes = nullptr;
+    std::vector< int > m_colours = {}; // by position in nodes
+    int m_num_colours = 0;
+};
+
 /**
  * Factory function to produce a new GroupInfo struct
  * for the next round of recursion
@@ -47,10 +136,7 @@ auto GetNewGroupInfo( group_t const& original_group
         {
             if ( ++( newGInfo.missedConnectionsCount[groupIndex] ) == maxMissedConnections )
             {
-                newGInfo.tailset = GetIntersection( std::crbegin( edges[ newGInfo.group[ groupIndex ] ] )
-                                                  , std::crend  ( edges[ newGInfo.group[ groupIndex ] ] )
-                                                  , std::cbegin ( newGInfo.tailset )
-                                                  , std::cend   ( newGInfo.tailset ) );
+                GetNeighboursIn( edges[ newGInfo.group[ groupIndex ] ], newGInfo.tailset, newGInfo.tailset );
                 if (newGInfo.tailset.size() + original_group_size + 1 < static_cast< size_t >(groupSize)) // there is not enough nodes in tailset anymore
                 {
                     newGInfo.tailset.clear();
@@ -64,37 +150,59 @@ auto GetNewGroupInfo( group_t const& original_group
     newGInfo.missedConnectionsCount.push_back(original_group_size - neighbors.size());
     if (original_group_size - neighbors.size() == static_cast< size_t >(maxMissedConnections))
     {
-        newGInfo.tailset = GetIntersection( std::crbegin( edges[ newNode ] )
-                                          , std::crend  ( edges[ newNode ] )
-                                          , std::cbegin ( newGInfo.tailset )
-                                          , std::cend   ( newGInfo.tailset ) );
+        GetNeighboursIn( edges[ newNode ], newGInfo.tailset, newGInfo.tailset );
     }
     return newGInfo;
 }
 
 
 
-void ListKCoresRecursive( GroupInfo gInfo, adjacency_list_t const& edges, group_list_t & candidates, int groupSize, vertex_degree_t coreSize )
+/**
+ * Passes every k-core of size groupSize that extends gInfo.group with vertices of its tailset to emit
+ */
+template < typename Emit >
+void ListKCoresRecursive( GroupInfo gInfo, adjacency_list_t const& edges, Colouring const& colouring, Emit & emit, int groupSize, vertex_degree_t coreSize )
 {
     vertex_degree_t const maxMissedConnections = groupSize - coreSize - 1;
 
+    std::vector< int > bounds;
+    if( ! colouring.IsEmpty() )
+    {
+        colouring.GetSuffixBounds( gInfo.tailset, maxMissedConnections, bounds );
+    }
+
+    bool const is_last_slot = gInfo.group.size() == static_cast< size_t >( groupSize - 1 );
+    vertex_list_t neighbours; // reused for every new node
     for( auto it_newNode = std::cbegin( gInfo.tailset ); it_newNode != std::cend( gInfo.tailset ); ++it_newNode )
     {
-        vertex_id_t   const newNode = *it_newNode;
-        vertex_list_t const neighbours = GetIntersection( std::crbegin( edges[ newNode ] )
-                                                        , std::crend  ( edges[ newNode ] )
-                                                        , std::cbegin ( gInfo.group )
-                                                        , std::cend   ( gInfo.group ) );
+        // the rest of the tailset only shrinks, so once no extension can reach groupSize, none ever will
+        if( ! bounds.empty() && gInfo.group.size() + bounds[ it_newNode - std::cbegin( gInfo.tailset ) ] < static_cast< size_t >( groupSize ) )
+        {
+            metrics::Add( metrics::Counter::branches_pruned_by_colouring );
+            break;
+        }
+
+        vertex_id_t const newNode = *it_newNode;
+        std::size_t num_neighbours;
+        if( is_last_slot ) // only the number of neighbours matters
+        {
+            num_neighbours = CountNeighboursIn( edges[ newNode ], gInfo.group );
+        }
+        else
+        {
+            GetNeighboursIn( edges[ newNode ], gInfo.group, neighbours );
+            num_neighbours = neighbours.size();
+        }
 
-        vertex_degree_t const num_nodes_not_in_intersection = gInfo.group.size() - neighbours.size();
+        vertex_degree_t const num_nodes_not_in_intersection = gInfo.group.size() - num_neighbours;
         if( num_nodes_not_in_intersection <= maxMissedConnections )
         {
-            if( gInfo.group.size() == static_cast< size_t >( groupSize - 1 ) )
+            if( is_last_slot )
             {
                 // We have a group!! Push it on, copy it to the solution set, and pop it off
                 // so that we can reuse the group.
                 gInfo.group.push_back( newNode );
-                candidates.push_back( gInfo.group );
+                emit( gInfo.group );
                 gInfo.group.pop_back();
             }
             else // there is more than one remaining slot to fill
@@ -110,7 +218,8 @@ void ListKCoresRecursive( GroupInfo gInfo, adjacency_list_t const& edges, group_
                                                     , maxMissedConnections
                                                     , groupSize )
                                    , edges
-                                   , candidates
+                                   , colouring
+                                   , emit
                                    , groupSize
                                    , coreSize );
             }
@@ -119,17 +228,12 @@ void ListKCoresRecursive( GroupInfo gInfo, adjacency_list_t const& edges, group_
     }
 }
 
-} // namespace anonymous
-
-
-namespace base {
-namespace listing {
-namespace cousins_first {
-
-auto ListKCoresWithPrefix( vertex_list_t const& nodes, adjacency_list_t const& edges, int groupSize, int coreSize ) -> group_list_t
+/**
+ * Passes every k-core of size groupSize that contains nodes[0] and other vertices of nodes to emit
+ */
+template < typename Emit >
+void ListKCoresFromPrefix( vertex_list_t const& nodes, adjacency_list_t const& edges, int groupSize, int coreSize, base::listing::cousins_first::Bound bound, Emit & emit )
 {
-    group_list_t kcores;
-
     // Launch recursion
     if( static_cast< vertex_degree_t >( nodes.size() ) >= groupSize )
     {
@@ -140,7 +244,7 @@ auto ListKCoresWithPrefix( vertex_list_t const& nodes, adjacency_list_t const& e
         {
             // If we're looking for cliques, use only the neighbours of the
             // prefix node as the tailset, since all nodes should be connected.
-            tailset = vertex_list_t( edges[prefix_node].crbegin(), edges[prefix_node].crend() );
+            GetNeighboursIn( edges[ prefix_node ], sorted_view_t( nodes ).subspan( 1 ), tailset );
         }
         else
         {
@@ -149,16 +253,36 @@ auto ListKCoresWithPrefix( vertex_list_t const& nodes, adjacency_list_t const& e
 
 	    ListKCoresRecursive( GroupInfo{ { prefix_node }, { 0 }, tailset }
 	                       , edges
-	                       , kcores
+	                       , bound == base::listing::cousins_first::Bound::colouring ? Colouring( nodes, edges ) : Colouring()
+	                       , emit
 	                       , groupSize
 	                       , coreSize );
 	}
+}
 
+} // namespace anonymous
+
+
+namespace base {
+namespace listing {
+namespace cousins_first {
+
+auto ListKCoresWithPrefix( vertex_list_t const& nodes, adjacency_list_t const& edges, int groupSize, int coreSize, Bound bound ) -> group_list_t
+{
+    group_list_t kcores;
+    auto emit = [ &kcores ]( group_t const& group ){ kcores.push_back( group ); };
+    ListKCoresFromPrefix( nodes, edges, groupSize, coreSize, bound, emit );
     return kcores;
 }
 
+void ListKCoresWithPrefix( vertex_list_t const& nodes, adjacency_list_t const& edges, int groupSize, int coreSize, label_list_t const& labels, GroupStore & kcores, Bound bound )
+{
+    auto emit = [ &kcores, &labels ]( group_t const& group ){ kcores.Append( group, labels ); };
+    ListKCoresFromPrefix( nodes, edges, groupSize, coreSize, bound, emit );
+}
+
 
-auto ListAllKCores( adjacency_list_t edges, vertex_degree_t groupSize, vertex_degree_t coreSize ) -> group_list_t
+auto ListAllKCores( adjacency_list_t edges, vertex_degree_t groupSize, vertex_degree_t coreSize, Bound bound ) -> group_list_t
 {
     group_list_t kcores;
 
@@ -185,7 +309,8 @@ auto ListAllKCores( adjacency_list_t edges, vertex_degree_t groupSize, vertex_de
                 group_list_t const kcores_with_new_prefix = ListKCoresWithPrefix( nodes
                                                                                 , edges
                                                                                 , groupSize
-                                                                                , coreSize );
+                                                                                , coreSize
+                                                                                , bound );
 
                 kcores.reserve( kcores.size() + kcores_with_new_prefix.size() );
                 kcores.insert( std::end   ( kcores )
@@ -1,125 +1,230 @@
+#include <boost/program_options.hpp> // for handling input arguments
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <optional>
 
+#include "datasets.hpp"
 #include "graph.hpp"
+#include "metrics.hpp"
+#include "result-writer.hpp"
+#include "skyline-engine.hpp"
 #include "timer.hpp"
-#include "ns-functions.hpp"
-#include "zhang19.hpp"
+#include "trace.hpp"
+
+using base::Algorithm;
 
 namespace { // anonymous
 
-enum class Algorithm
+const char* ARG_HELP        = "help,h";
+const char* ARG_KPLEX       = "k-plex,k";
+const char* ARG_GROUP       = "group-size,g";
+const char* ARG_EDGES       = "edges,e";
+const char* ARG_LABELS      = "labels,l";
+const char* ARG_VERTICES    = "vertices,n";
+const char* ARG_DIMENSION   = "dimension,d";
+const char* ARG_DATASET     = "dataset,D";
+const char* ARG_LABEL_TYPE  = "label-type,L";
+const char* ARG_DIRECTORY   = "datasets-directory";
+const char* ARG_ALGORITHM   = "algorithm,a";
+const char* ARG_THREADS     = "threads,t";
+const char* ARG_OUTPUT      = "output,o";
+const char* ARG_WITH_LABELS = "with-labels";
+const char* ARG_WHERE       = "where,w";
+const char* ARG_SUBSET      = "vertex-subset";
+const char* ARG_SUBSPACE    = "subspace";
+const char* ARG_TIME_BUDGET = "time-budget";
+const char* ARG_WORK_BUDGET = "work-budget";
+
+/**
+ * Accepts an algorithm by name or by its number in base::Algorithm
+ */
+auto ParseAlgorithm( std::string const& name ) -> std::optional< Algorithm >
+{
+    if( name == "skcore"   || name == "0" ) { return Algorithm::skcore; }
+    if( name == "pkcore"   || name == "1" ) { return Algorithm::pkcore; }
+    if( name == "baseline" || name == "2" ) { return Algorithm::baseline; }
+    return std::nullopt;
+}
+
+/**
+ * Reads whitespace-separated vertex ids, in the ids of the input files
+ */
+auto LoadVertexSubset( std::string const& filePath ) -> vertex_list_t
 {
-    skcore = 0,
-    pkcore = 1,
-    baseline = 2
-};
+    std::ifstream file( filePath );
+    if( ! file.is_open() )
+    {
+        throw std::invalid_argument( "could not open " + filePath );
+    }
+    vertex_list_t vertices;
+    for( vertex_id_t vertex; file >> vertex; )
+    {
+        vertices.push_back( vertex );
+    }
+    if( ! file.eof() )
+    {
+        throw std::invalid_argument( "malformed vertex id in " + filePath );
+    }
+    return vertices;
+}
 
 } // namespace anonymous
 
 
 int main (int argc, char** argv)
 {
-    if (argc < 7)
+    int kPlexSize; // k
+    int groupSize; // g
+    std::string edgesFilePath;
+    std::string labelsFilePath;
+    std::optional< vertex_id_t > nodeSize; // vertices to load; all if not given
+    int dimension;
+    int dataset;
+    int labelType;
+    std::string datasetsDirectory;
+    std::string algorithmName;
+    int nThreads = 0; // only pkcore needs any, and it must be given them
+    std::string outputFilePath;
+    bool withLabels;
+    base::VertexFilter filter;
+    std::vector< dimension_t > subspace;
+    std::optional< int > timeBudget; // in milliseconds
+    std::optional< int > workBudget; // in vertices of the scan order
+
+    try
+    {
+        namespace po = boost::program_options;
+
+        po::options_description desc("Execution arguments for computing skyline communities; "
+                                      "k g d dataset label-type algorithm threads can also be given positionally");
+        desc.add_options()
+            (ARG_HELP, "show usage instructions")
+            (ARG_KPLEX,      po::value< int >( &kPlexSize )->required(), "k of the k-plex (clique relaxation)")
+            (ARG_GROUP,      po::value< int >( &groupSize )->required(), "number of vertices in each group")
+            (ARG_EDGES,      po::value< std::string >( &edgesFilePath ), "edge file, CSV or binary (.bin); vertex count is detected")
+            (ARG_LABELS,     po::value< std::string >( &labelsFilePath ), "label file, CSV or binary (.bin); dimension is detected")
+            (ARG_VERTICES,   po::value< vertex_id_t >(), "only load vertices with smaller ids (default: all labelled vertices)")
+            (ARG_DATASET,    po::value< int >( &dataset ), "instead of files, a dataset id; 4:YouTube, 5:case study, 10:LiveJournal, 11:DBLP, 12:Amazon, 13:WikiTalk, 14:CitPatent")
+            (ARG_DIMENSION,  po::value< int >( &dimension ), "label dimensionality of the dataset")
+            (ARG_LABEL_TYPE, po::value< int >( &labelType )->default_value( 0 ), "label type of the dataset; 0:indep, 1:corr, 2:anti-corr")
+            (ARG_DIRECTORY,  po::value< std::string >( &datasetsDirectory )->default_value( default_datasets_directory ), "directory holding the dataset files")
+            (ARG_ALGORITHM,  po::value< std::string >( &algorithmName )->default_value( "pkcore" ), "algorithm; choices are: {skcore (0), pkcore (1), baseline (2)}")
+            (ARG_THREADS,    po::value< int >( &nThreads ), "number of threads; required for pkcore")
+            (ARG_OUTPUT,     po::value< std::string >( &outputFilePath ), "file to stream the skyline groups to, in input vertex ids; binary if it ends in .bin, otherwise CSV")
+            (ARG_WITH_LABELS, po::bool_switch( &withLabels ), "also write the best and worst virtual point of each group")
+            (ARG_WHERE,      po::value< std::vector< std::string > >()->multitoken(), "only admit vertices whose labels lie in each range <dimension>:<lower>:<upper>; either bound may be empty")
+            (ARG_SUBSET,     po::value< std::string >(), "only admit the vertices whose ids are listed in this file")
+            (ARG_SUBSPACE,   po::value< std::vector< dimension_t > >( &subspace )->multitoken(), "only compare labels in these dimensions, in this order; --where then refers to them")
+            (ARG_TIME_BUDGET, po::value< int >(), "stop after this many milliseconds with the part of the skyline that is final so far")
+            (ARG_WORK_BUDGET, po::value< int >(), "stop after scanning this many vertices with the part of the skyline that is final so far")
+            ;
+
+        po::positional_options_description positional;
+        positional.add( "k-plex", 1 ).add( "group-size", 1 ).add( "dimension", 1 ).add( "dataset", 1 )
+                  .add( "label-type", 1 ).add( "algorithm", 1 ).add( "threads", 1 );
+
+        po::variables_map vm;
+        po::store( po::command_line_parser( argc, argv ).options( desc ).positional( positional ).run(), vm );
+
+        // If someone needs help, nothing else matters.
+        if ( vm.count("help") || argc == 1 )
+        {
+            std::cout << desc << std::endl;
+            return 0;
+        }
+        po::notify( vm );
+
+        if( vm.count( "vertices" ) )
+        {
+            nodeSize = vm[ "vertices" ].as< vertex_id_t >();
+        }
+        if( vm.count( "where" ) )
+        {
+            for( auto const& range : vm[ "where" ].as< std::vector< std::string > >() )
+            {
+                filter.ranges.push_back( base::ParseLabelRange( range ) );
+            }
+        }
+        if( vm.count( "vertex-subset" ) )
+        {
+            filter.vertices = LoadVertexSubset( vm[ "vertex-subset" ].as< std::string >() );
+        }
+        if( vm.count( "time-budget" ) )
+        {
+            timeBudget = vm[ "time-budget" ].as< int >();
+        }
+        if( vm.count( "work-budget" ) )
+        {
+            workBudget = vm[ "work-budget" ].as< int >();
+        }
+
+        if( edgesFilePath.empty() != labelsFilePath.empty() )
+        {
+            throw std::invalid_argument( "--edges and --labels must be given together" );
+        }
+        if( edgesFilePath.empty() )
+        {
+            if( ! vm.count( "dataset" ) || ! vm.count( "dimension" ) )
+            {
+                throw std::invalid_argument( "give either --edges and --labels, or --dataset and --dimension" );
+            }
+            auto const datasetInfo = GetDataset( dataset );
+            if( ! datasetInfo )
+            {
+                throw std::invalid_argument( "invalid dataset" );
+            }
+            if( labelType < 0 || labelType > 2 )
+            {
+                throw std::invalid_argument( "invalid label type" );
+            }
+            std::cout << "dataset = " << datasetInfo->name << std::endl;
+            std::cout << "label type = " << ToString( static_cast< LabelType >( labelType ) ) << std::endl;
+            edgesFilePath = datasetsDirectory + datasetInfo->edgesFile;
+            labelsFilePath = datasetsDirectory + GetLabelsFile( static_cast< LabelType >( labelType ), dimension );
+        }
+    }
+    catch( std::exception const& e )
     {
-        std::cout << "not enough input parameters...\n";
-        return -1;
-    }   
+        std::cerr << "error: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
 
-    const int kPlexSize = std::stoi(argv[1]); // k
-    const int groupSize = std::stoi(argv[2]); // g
-    const int coreSize = groupSize - kPlexSize - 1; // convert to co-plex for backwards compatability with earlier code design choices.
-    const int dimension = std::stoi(argv[3]); // d
-    const int dataset = std::stoi(argv[4]); // 4:YouTube, 5:case study, 10:LiveJournal, 11:DBLP, 12:Amazon, 13:WikiTalk, 14:CitPatent
-    const int labelType = std::stoi(argv[5]); // 0:indep, 1:corr, 2:anti-corr
-    const Algorithm algorithm = static_cast< Algorithm >( std::stoi(argv[6]) ); // 0:skcore, 1:pkcore, 2:baseline
-    int nThreads = 0;
+    auto const algorithm = ParseAlgorithm( algorithmName );
+    if (!algorithm)
+    {
+        std::cout << "invalid algorithm...\n";
+        return EXIT_FAILURE;
+    }
 
-    if (groupSize > 2*coreSize+1 || groupSize <= coreSize)
+    base::SkylineQuery const query{ .kPlexSize = kPlexSize
+                                  , .groupSize = groupSize
+                                  , .algorithm = *algorithm
+                                  , .nThreads = nThreads
+                                  , .filter = filter
+                                  , .dimensions = subspace };
+    if (auto const reason = base::ValidateQuery(query); !reason.empty())
     {
-        std::cout << "invalid k and/or g parameters...\n";
-        return -1;
+        std::cout << reason << "...\n";
+        return EXIT_FAILURE;
     }
 
-    std::cout << "coreSize = " << coreSize << std::endl;
+    std::cout << "coreSize = " << query.GetCoreSize() << std::endl;
     std::cout << "groupSize = " << groupSize << std::endl;
-    std::cout << "dimension = " << dimension << std::endl;
-
-    int nodeSize = 0 ; // to be updated based on "dataset", this is the maximum nodeID which may be different than the actual number of nodes
-    std::string edgesFilePath = ""; // to be updated based on "dataset"
-
-     // to be updated based on "d" and "labelType"
-    std::string labelsFilePath = "../../datasets/";
-    switch(dataset)
-    {
-        case 4:
-            edgesFilePath = "../../datasets/com-youtube.ungraph_undirected.csv";
-            nodeSize = 1157828;
-            std::cout << "dataset = YouTube" << std::endl;
-            break;
-        case 5:
-            edgesFilePath = "../../datasets/case_study_edges.csv";
-            nodeSize = 5856;
-            std::cout << "dataset = Casestudy" << std::endl;
-            break;
-        case 10:
-            edgesFilePath = "../../datasets/LiveJournal_undirected.csv";
-            nodeSize = 4847571;
-            std::cout << "dataset = LiveJournal" << std::endl;
-            break;
-        case 11:
-            edgesFilePath = "../../datasets/dblp_undirected.csv";
-            nodeSize = 425957;
-            std::cout << "dataset = DBLP" << std::endl;
-            break;
-        case 12:
-            edgesFilePath = "../../datasets/amazon_undirected.csv";
-            nodeSize = 735324;
-            std::cout << "dataset = Amazon" << std::endl;
-            break;
-        case 13:
-            edgesFilePath = "../../datasets/wiki_talk_undirected.csv";
-            nodeSize = 2394385;
-            std::cout << "dataset = WikiTalk" << std::endl;
-            break;
-        case 14:
-            edgesFilePath = "../../datasets/cit_patents_undirected.csv";
-            nodeSize = 6009555;
-            std::cout << "dataset = CitPatent" << std::endl;
-            break;
-        default:
-            std::cout << "invalid dataset...\n";
-            return -1;
-    }
-
-    switch(labelType)
-    {
-        case 0:
-            labelsFilePath += "indep-";
-            std::cout << "label type = independent" << std::endl;
-            break;
-        case 1:
-            labelsFilePath += "corr-scale=0.5-";
-            std::cout << "label type = correlated" << std::endl;
-            break;
-        case 2:
-            labelsFilePath += "anticorr-";
-            std::cout << "label type = anti-correlated" << std::endl;
-            break;
-        default:
-            std::cout << "invalid label type...\n";
-            return -1;
-    }
-
-    labelsFilePath += std::to_string(dimension) + "d.csv";
-
-    if (algorithm == Algorithm::pkcore)
-    {
-        if (argc < 8 || std::stoi(argv[7]) < 1)
+    std::cout << "edges = " << edgesFilePath << std::endl;
+    std::cout << "labels = " << labelsFilePath << std::endl;
+    if (!filter.IsEmpty())
+    {
+        std::cout << "vertex filter: " << filter.ranges.size() << " label range(s)";
+        if (filter.vertices)
         {
-            std::cout << "invalid number of threads...\n";
-            return -1;
+            std::cout << ", " << filter.vertices->size() << " listed vertices";
         }
-        nThreads = std::stoi(argv[7]);
+        std::cout << std::endl;
+    }
+    if (*algorithm == Algorithm::pkcore)
+    {
         std::cout << "running in parallel - > #threads: " << nThreads << std::endl;
     }
     else
@@ -129,45 +234,107 @@ int main (int argc, char** argv)
 
     std::cout << "--**--**--**--**\n";
 
-    Graph myGraph;
+    std::optional< base::SkylineEngine > engine;
     {
         Time time("Preprocessing Time: ");
-        if (LoadEdges(edgesFilePath, myGraph.edges, nodeSize) && LoadLabels(labelsFilePath, myGraph.labels, nodeSize))
+        Graph myGraph;
+        try
         {
-            std::cout << "Data loaded...\n";
+            if (!LoadGraph(edgesFilePath, labelsFilePath, myGraph, nodeSize))
+            {
+                return EXIT_FAILURE;
+            }
         }
-        else
+        catch (std::runtime_error const& e) // a binary file whose header does not match its size
         {
-            return -1;
+            std::cerr << "error: " << e.what() << std::endl;
+            return EXIT_FAILURE;
         }
-        UpdateGraph(myGraph);
+        std::cout << "Data loaded: " << myGraph.size << " vertices, dimension = "
+                  << (myGraph.labels.empty() ? 0 : myGraph.labels.front().size()) << std::endl;
+        engine.emplace( std::move( myGraph ) );
         std::cout << "Preprocessing done...\n";
     }
 
+    // Hardware counters are read around each phase if requested and permitted by the kernel
+    metrics::SetHardwareCountersEnabled(std::getenv("KSKYCORE_PERF_COUNTERS") != nullptr);
+
+    // Timeline tracing is switched on by naming the file to write it to
+    char const* const tracePath = std::getenv("KSKYCORE_TRACE");
+    trace::SetEnabled(tracePath != nullptr);
+    trace::Clear();
+
+    std::ofstream outputFile;
+    std::optional< base::ResultWriter > writer;
+    QueryContext context;
+    if (!outputFilePath.empty())
+    {
+        outputFile.open(outputFilePath, std::ios::binary);
+        if (!outputFile.is_open())
+        {
+            std::cout << "Could not open " << outputFilePath << "...\n";
+            return EXIT_FAILURE;
+        }
+        writer.emplace(outputFile, engine->GetGraph(), IsBinaryFile(outputFilePath) ? base::ResultFormat::binary : base::ResultFormat::csv, withLabels);
+        context.sink = &*writer;
+    }
+
+    QueryProgress progress;
+    context.progress = &progress;
+    metrics::QueryRecord record;
+    context.record = &record;
+    context.budget.max_scanned = workBudget;
+    if (timeBudget)
+    {
+        context.budget.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(*timeBudget);
+    }
+
     intVec2D communities;
-    if (algorithm == Algorithm::skcore)
+    try
     {
-        Time time("SK-Core Execution Time: ");
-        communities = base::sequential::GetSkylineCommunities( myGraph, coreSize, groupSize );
+        if (*algorithm == Algorithm::skcore)
+        {
+            Time time("SK-Core Execution Time: ");
+            communities = engine->Query( query, context );
+        }
+        else if (*algorithm == Algorithm::pkcore)
+        {
+            Time time("PK-Core Execution Time: ");
+            communities = engine->Query( query, context );
+        }
+        else
+        {
+            Time time("Baseline Execution Time: ");
+            communities = engine->Query( query, context );
+        }
     }
-    else if (algorithm == Algorithm::pkcore)
+    catch( std::invalid_argument const& e ) // e.g., a vertex filter that does not fit the loaded graph
     {
-        auto const num_threads = std::atoi( argv[ 7 ] );
-        Time time("PK-Core Execution Time: ");
-        communities = base::parallel::GetSkylineCommunities( myGraph, coreSize, groupSize, num_threads );
+        std::cerr << "error: " << e.what() << std::endl;
+        return EXIT_FAILURE;
     }
-    else if (algorithm == Algorithm::baseline)
+
+    if (writer)
     {
-        Time time("Baseline Execution Time: ");
-        base::zhang::GetSkylineCommunities(myGraph, coreSize, groupSize, communities);
+        writer->Flush();
+        std::cout << "Skyline groups written to " << outputFilePath << std::endl;
     }
-    else 
+    std::cout << "#Skyline Groups: " << (writer ? writer->GetNumGroups() : communities.size()) << std::endl;
+    if (!progress.complete)
     {
-        std::cout << "invalid algorithm...\n";
-        return -1;
+        std::cout << "Partial skyline: budget ran out after " << progress.scanned << " of " << engine->GetGraph().size
+                  << " vertices in scan order (next: vertex " << progress.frontier << "), " << progress.layers_completed
+                  << " of " << progress.num_layers << " sky layers complete; every group listed is in the skyline, and"
+                  << " every skyline group with a member in a complete layer is listed" << std::endl;
     }
+    std::cout << "Metrics: " << metrics::ToJson( metrics::Collect( &record ) ) << std::endl;
 
-    std::cout << "#Skyline Groups: " <<  communities.size() << std::endl;
+    if (tracePath != nullptr)
+    {
+        std::ofstream traceFile(tracePath);
+        trace::WriteChromeTrace(traceFile);
+        std::cout << "Trace written to " << tracePath << std::endl;
+    }
 
-    return 0; 
-}
\ No newline at end of file
+    return 0;
+}
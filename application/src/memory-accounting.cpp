@@ -0,0 +1,190 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <sys/resource.h>
+
+#include "memory-accounting.hpp"
+
+namespace { // anonymous
+
+std::array< std::atomic< std::int64_t >, memory::num_subsystems > current_bytes = {};
+std::array< std::atomic< std::int64_t >, memory::num_subsystems > peak_bytes = {};
+
+std::atomic< std::int64_t > heap_live_bytes = 0;
+std::atomic< std::int64_t > heap_peak_bytes = 0;
+std::atomic< std::uint64_t > heap_allocated_bytes = 0;
+std::atomic< std::uint64_t > heap_allocations = 0;
+
+void RaiseTo( std::atomic< std::int64_t > & peak, std::int64_t const value )
+{
+    std::int64_t previous = peak.load( std::memory_order_relaxed );
+    while( previous < value && ! peak.compare_exchange_weak( previous, value, std::memory_order_relaxed ) )
+    {
+    }
+}
+
+#ifdef KSKYCORE_MEMORY_ACCOUNTING
+
+/**
+ * Every block is preceded by a header that records its size, so that unsized deletes can be accounted for.
+ * The header is a multiple of the alignment so that the block handed out keeps it.
+ */
+std::size_t constexpr default_header_bytes = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+auto HeaderBytes( std::size_t const alignment ) -> std::size_t
+{
+    return std::max( default_header_bytes, alignment );
+}
+
+void RecordAllocation( std::size_t const size )
+{
+    heap_allocations.fetch_add( 1, std::memory_order_relaxed );
+    heap_allocated_bytes.fetch_add( size, std::memory_order_relaxed );
+    RaiseTo( heap_peak_bytes, heap_live_bytes.fetch_add( size, std::memory_order_relaxed ) + size );
+}
+
+auto TryAllocate( std::size_t const size, std::size_t const alignment ) -> void *
+{
+    std::size_t const header = HeaderBytes( alignment );
+    void * const block = alignment > default_header_bytes
+                       ? std::aligned_alloc( alignment, ( size + header + alignment - 1 ) / alignment * alignment )
+                       : std::malloc( size + header );
+    if( block == nullptr )
+    {
+        return nullptr;
+    }
+    RecordAllocation( size );
+    char * const user = static_cast< char * >( block ) + header;
+    *reinterpret_cast< std::size_t * >( user - sizeof( std::size_t ) ) = size;
+    return user;
+}
+
+auto Allocate( std::size_t const size, std::size_t const alignment ) -> void *
+{
+    while( true )
+    {
+        if( void * const user = TryAllocate( size, alignment ) )
+        {
+            return user;
+        }
+        if( auto const handler = std::get_new_handler() )
+        {
+            handler();
+        }
+        else
+        {
+            throw std::bad_alloc();
+        }
+    }
+}
+
+void Deallocate( void * const user, std::size_t const alignment )
+{
+    if( user == nullptr )
+    {
+        return;
+    }
+    char * const bytes = static_cast< char * >( user );
+    std::size_t const size = *reinterpret_cast< std::size_t * >( bytes - sizeof( std::size_t ) );
+    heap_live_bytes.fetch_sub( size, std::memory_order_relaxed );
+    std::free( bytes - HeaderBytes( alignment ) );
+}
+
+#endif // KSKYCORE_MEMORY_ACCOUNTING
+
+} // namespace anonymous
+
+
+#ifdef KSKYCORE_MEMORY_ACCOUNTING
+
+// Replacements of the global allocation functions; every other form forwards to one of these.
+
+void * operator new  ( std::size_t size ) { return Allocate( size, default_header_bytes ); }
+void * operator new[]( std::size_t size ) { return Allocate( size, default_header_bytes ); }
+void * operator new  ( std::size_t size, std::align_val_t alignment ) { return Allocate( size, static_cast< std::size_t >( alignment ) ); }
+void * operator new[]( std::size_t size, std::align_val_t alignment ) { return Allocate( size, static_cast< std::size_t >( alignment ) ); }
+void * operator new  ( std::size_t size, std::nothrow_t const& ) noexcept { return TryAllocate( size, default_header_bytes ); }
+void * operator new[]( std::size_t size, std::nothrow_t const& ) noexcept { return TryAllocate( size, default_header_bytes ); }
+void * operator new  ( std::size_t size, std::align_val_t alignment, std::nothrow_t const& ) noexcept { return TryAllocate( size, static_cast< std::size_t >( alignment ) ); }
+void * operator new[]( std::size_t size, std::align_val_t alignment, std::nothrow_t const& ) noexcept { return TryAllocate( size, static_cast< std::size_t >( alignment ) ); }
+
+void operator delete  ( void * block ) noexcept { Deallocate( block, default_header_bytes ); }
+void operator delete[]( void * block ) noexcept { Deallocate( block, default_header_bytes ); }
+void operator delete  ( void * block, std::size_t ) noexcept { Deallocate( block, default_header_bytes ); }
+void operator delete[]( void * block, std::size_t ) noexcept { Deallocate( block, default_header_bytes ); }
+void operator delete  ( void * block, std::nothrow_t const& ) noexcept { Deallocate( block, default_header_bytes ); }
+void operator delete[]( void * block, std::nothrow_t const& ) noexcept { Deallocate( block, default_header_bytes ); }
+void operator delete  ( void * block, std::align_val_t alignment ) noexcept { Deallocate( block, static_cast< std::size_t >( alignment ) ); }
+void operator delete[]( void * block, std::align_val_t alignment ) noexcept { Deallocate( block, static_cast< std::size_t >( alignment ) ); }
+void operator delete  ( void * block, std::size_t, std::align_val_t alignment ) noexcept { Deallocate( block, static_cast< std::size_t >( alignment ) ); }
+void operator delete[]( void * block, std::size_t, std::align_val_t alignment ) noexcept { Deallocate( block, static_cast< std::size_t >( alignment ) ); }
+void operator delete  ( void * block, std::align_val_t alignment, std::nothrow_t const& ) noexcept { Deallocate( block, static_cast< std::size_t >( alignment ) ); }
+void operator delete[]( void * block, std::align_val_t alignment, std::nothrow_t const& ) noexcept { Deallocate( block, static_cast< std::size_t >( alignment ) ); }
+
+#endif // KSKYCORE_MEMORY_ACCOUNTING
+
+
+namespace memory
+{
+
+auto ToString( Subsystem subsystem ) -> char const*
+{
+    switch( subsystem )
+    {
+        case Subsystem::graph:         return "graph";
+        case Subsystem::labels:        return "labels";
+        case Subsystem::sky_layers:    return "sky_layers";
+        case Subsystem::neighbourhood: return "neighbourhood";
+        case Subsystem::candidates:    return "candidates";
+        case Subsystem::skyline:       return "skyline";
+        case Subsystem::count_:        break;
+    }
+    return "unknown";
+}
+
+void AddBytes( Subsystem subsystem, std::int64_t bytes )
+{
+    auto const i = static_cast< std::size_t >( subsystem );
+    RaiseTo( peak_bytes[ i ], current_bytes[ i ].fetch_add( bytes, std::memory_order_relaxed ) + bytes );
+}
+
+auto PeakHeapBytes() -> std::int64_t
+{
+    return heap_peak_bytes.load( std::memory_order_relaxed );
+}
+
+auto PeakResidentKilobytes() -> std::int64_t
+{
+    rusage usage;
+    return getrusage( RUSAGE_SELF, &usage ) == 0 ? usage.ru_maxrss : 0; // kilobytes on Linux
+}
+
+auto Collect() -> Usage
+{
+    Usage usage;
+    usage.heap.live_bytes      = heap_live_bytes.load( std::memory_order_relaxed );
+    usage.heap.peak_bytes      = heap_peak_bytes.load( std::memory_order_relaxed );
+    usage.heap.allocated_bytes = heap_allocated_bytes.load( std::memory_order_relaxed );
+    usage.heap.allocations     = heap_allocations.load( std::memory_order_relaxed );
+    for( std::size_t i = 0; i < num_subsystems; ++i )
+    {
+        usage.subsystems[ i ] = { current_bytes[ i ].load( std::memory_order_relaxed )
+                                , peak_bytes[ i ].load( std::memory_order_relaxed ) };
+    }
+    usage.peak_rss_kb = PeakResidentKilobytes();
+    return usage;
+}
+
+void ResetPeaks()
+{
+    heap_peak_bytes.store( heap_live_bytes.load( std::memory_order_relaxed ), std::memory_order_relaxed );
+    heap_allocated_bytes.store( 0, std::memory_order_relaxed );
+    heap_allocations.store( 0, std::memory_order_relaxed );
+    for( std::size_t i = 0; i < num_subsystems; ++i )
+    {
+        peak_bytes[ i ].store( current_bytes[ i ].load( std::memory_order_relaxed ), std::memory_order_relaxed );
+    }
+}
+
+} // namespace memory
@@ -0,0 +1,310 @@
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <sstream>
+
+#include "metrics.hpp"
+
+namespace { // anonymous
+
+/**
+ * Owns the metrics of every thread that recorded any, so that they outlive the threads themselves and can be
+ * aggregated afterwards. The slots of exited threads are reused, and their hardware counters, which only
+ * count the thread that opened them, are closed.
+ */
+struct Registry
+{
+    std::mutex mutex;
+    std::vector< std::unique_ptr< metrics::ThreadMetrics > > threads;
+    std::vector< metrics::ThreadMetrics * > free_threads;
+    std::vector< std::unique_ptr< PerfCounterGroup > > counters;
+    std::array< bool, num_hardware_events > hardware_events_available = {};
+};
+
+auto GetRegistry() -> Registry &
+{
+    static Registry registry;
+    return registry;
+}
+
+/**
+ * Releases the calling thread's slot and hardware counters to the registry when the thread exits
+ */
+struct ThreadRegistration
+{
+    metrics::ThreadMetrics * slot = nullptr;
+    PerfCounterGroup const* counters = nullptr;
+
+    ~ThreadRegistration()
+    {
+        auto & registry = GetRegistry();
+        std::lock_guard lock( registry.mutex );
+        if( slot != nullptr )
+        {
+            registry.free_threads.push_back( slot );
+        }
+        if( counters != nullptr )
+        {
+            std::erase_if( registry.counters, [ this ]( auto const& group ){ return group.get() == counters; } );
+        }
+    }
+};
+
+thread_local ThreadRegistration t_registration;
+
+std::atomic< bool > hardware_counters_enabled = false;
+
+void Accumulate( metrics::ThreadMetrics & total, metrics::ThreadMetrics const& addend )
+{
+    for( std::size_t i = 0; i < metrics::num_counters; ++i )
+    {
+        total.counters[ i ] += addend.counters[ i ];
+    }
+    for( std::size_t i = 0; i < metrics::num_phases; ++i )
+    {
+        total.phases[ i ].nanoseconds += addend.phases[ i ].nanoseconds;
+        total.phases[ i ].invocations += addend.phases[ i ].invocations;
+        for( std::size_t j = 0; j < num_hardware_events; ++j )
+        {
+            total.phases[ i ].hardware[ j ] += addend.phases[ i ].hardware[ j ];
+        }
+        total.phases[ i ].peak_heap_bytes = std::max( total.phases[ i ].peak_heap_bytes, addend.phases[ i ].peak_heap_bytes );
+        total.phases[ i ].peak_rss_kb = std::max( total.phases[ i ].peak_rss_kb, addend.phases[ i ].peak_rss_kb );
+    }
+}
+
+void WriteThreadMetrics( std::ostream & json
+                       , metrics::ThreadMetrics const& thread_metrics
+                       , std::array< bool, num_hardware_events > const& hardware_events_available )
+{
+    json << "{\"phases\":{";
+    for( std::size_t i = 0; i < metrics::num_phases; ++i )
+    {
+        auto const& stats = thread_metrics.phases[ i ];
+        json << ( i ? "," : "" ) << '"' << metrics::ToString( static_cast< metrics::Phase >( i ) ) << "\":{"
+             << "\"ms\":" << static_cast< double >( stats.nanoseconds ) / 1e6
+             << ",\"invocations\":" << stats.invocations;
+        for( std::size_t j = 0; j < num_hardware_events; ++j )
+        {
+            if( hardware_events_available[ j ] )
+            {
+                json << ",\"" << ToString( static_cast< HardwareEvent >( j ) ) << "\":" << stats.hardware[ j ];
+            }
+        }
+        if constexpr( memory::accounting_enabled )
+        {
+            json << ",\"peak_heap_bytes\":" << stats.peak_heap_bytes
+                 << ",\"peak_rss_kb\":" << stats.peak_rss_kb;
+        }
+        json << "}";
+    }
+    json << "},\"counters\":{";
+    for( std::size_t i = 0; i < metrics::num_counters; ++i )
+    {
+        json << ( i ? "," : "" ) << '"' << metrics::ToString( static_cast< metrics::Counter >( i ) ) << "\":"
+             << thread_metrics.counters[ i ];
+    }
+    json << "}}";
+}
+
+void WriteMemoryUsage( std::ostream & json, memory::Usage const& usage )
+{
+    json << "{\"accounting\":" << ( memory::accounting_enabled ? "true" : "false" )
+         << ",\"peak_rss_kb\":" << usage.peak_rss_kb;
+    if constexpr( memory::accounting_enabled )
+    {
+        json << ",\"heap\":{\"live_bytes\":" << usage.heap.live_bytes
+             << ",\"peak_bytes\":" << usage.heap.peak_bytes
+             << ",\"allocated_bytes\":" << usage.heap.allocated_bytes
+             << ",\"allocations\":" << usage.heap.allocations
+             << "},\"subsystems\":{";
+        for( std::size_t i = 0; i < memory::num_subsystems; ++i )
+        {
+            json << ( i ? "," : "" ) << '"' << memory::ToString( static_cast< memory::Subsystem >( i ) ) << "\":{"
+                 << "\"current_bytes\":" << usage.subsystems[ i ].current_bytes
+                 << ",\"peak_bytes\":" << usage.subsystems[ i ].peak_bytes << "}";
+        }
+        json << "}";
+    }
+    json << "}";
+}
+
+} // namespace anonymous
+
+
+namespace metrics
+{
+
+auto ToString( Phase phase ) -> char const*
+{
+    switch( phase )
+    {
+        case Phase::load:                return "load";
+        case Phase::partition:           return "partition";
+        case Phase::sky_layers:          return "sky_layers";
+        case Phase::initial_peel:        return "initial_peel";
+        case Phase::neighbourhood:       return "neighbourhood";
+        case Phase::listing:             return "listing";
+        case Phase::dominance_filtering: return "dominance_filtering";
+        case Phase::postprocess:         return "postprocess";
+        case Phase::count_:              break;
+    }
+    return "unknown";
+}
+
+auto ToString( Counter counter ) -> char const*
+{
+    switch( counter )
+    {
+        case Counter::vertices_pruned_by_kcore:        return "vertices_pruned_by_kcore";
+        case Counter::vertices_excluded_by_filter:     return "vertices_excluded_by_filter";
+        case Counter::vertices_pruned_by_structure:    return "vertices_pruned_by_structure";
+        case Counter::vertices_skipped_by_termination: return "vertices_skipped_by_termination";
+        case Counter::vertices_skipped_by_suffix:      return "vertices_skipped_by_suffix";
+        case Counter::suffix_termination_tests:        return "suffix_termination_tests";
+        case Counter::candidates_listed:               return "candidates_listed";
+        case Counter::branches_pruned_by_colouring:    return "branches_pruned_by_colouring";
+        case Counter::group_dominance_tests:           return "group_dominance_tests";
+        case Counter::point_dominance_tests:           return "point_dominance_tests";
+        case Counter::parallel_rounds:                 return "parallel_rounds";
+        case Counter::count_:                          break;
+    }
+    return "unknown";
+}
+
+auto RegisterThread() -> ThreadMetrics *
+{
+    auto & registry = GetRegistry();
+    std::lock_guard lock( registry.mutex );
+    if( registry.free_threads.empty() )
+    {
+        t_registration.slot = registry.threads.emplace_back( std::make_unique< ThreadMetrics >() ).get();
+    }
+    else
+    {
+        t_registration.slot = registry.free_threads.back();
+        registry.free_threads.pop_back();
+    }
+    return t_registration.slot;
+}
+
+void SetHardwareCountersEnabled( bool const enabled )
+{
+    hardware_counters_enabled.store( enabled, std::memory_order_relaxed );
+}
+
+bool AreHardwareCountersEnabled()
+{
+    return hardware_counters_enabled.load( std::memory_order_relaxed );
+}
+
+auto RegisterThreadCounters() -> PerfCounterGroup const*
+{
+    auto counters = std::make_unique< PerfCounterGroup >();
+    if( ! counters->IsAvailable() )
+    {
+        return nullptr;
+    }
+
+    auto & registry = GetRegistry();
+    std::lock_guard lock( registry.mutex );
+    for( std::size_t i = 0; i < num_hardware_events; ++i )
+    {
+        registry.hardware_events_available[ i ] |= counters->IsAvailable( static_cast< HardwareEvent >( i ) );
+    }
+    t_registration.counters = registry.counters.emplace_back( std::move( counters ) ).get();
+    return t_registration.counters;
+}
+
+void RecordTermination( [[maybe_unused]] QueryRecord * const record, [[maybe_unused]] std::int64_t layer )
+{
+#ifdef KSKYCORE_METRICS
+    if( record != nullptr )
+    {
+        record->termination_layer = layer;
+    }
+#endif
+}
+
+void RecordSkylineSize( [[maybe_unused]] QueryRecord * const record, [[maybe_unused]] std::int64_t vertex, [[maybe_unused]] std::uint64_t size )
+{
+#ifdef KSKYCORE_METRICS
+    if( record != nullptr )
+    {
+        auto const elapsed = std::chrono::duration_cast< std::chrono::microseconds >( std::chrono::steady_clock::now() - record->start );
+        record->skyline_size.push_back( { static_cast< std::uint64_t >( elapsed.count() ), vertex, size } );
+    }
+#endif
+}
+
+auto Collect( QueryRecord const* const query ) -> Report
+{
+    auto & registry = GetRegistry();
+    std::lock_guard lock( registry.mutex );
+
+    Report report;
+    if( query != nullptr )
+    {
+        report.termination_layer = query->termination_layer;
+        report.skyline_size = query->skyline_size;
+    }
+    report.memory = memory::Collect();
+    for( auto const& thread_metrics : registry.threads )
+    {
+        Accumulate( report.totals, *thread_metrics );
+        report.per_thread.push_back( *thread_metrics );
+    }
+    report.hardware_events_available = registry.hardware_events_available;
+    return report;
+}
+
+void Reset()
+{
+    auto & registry = GetRegistry();
+    std::lock_guard lock( registry.mutex );
+
+    for( auto & thread_metrics : registry.threads )
+    {
+        *thread_metrics = ThreadMetrics{};
+    }
+    memory::ResetPeaks();
+}
+
+auto ToJson( Report const& report ) -> std::string
+{
+    std::ostringstream json;
+    json << "{\"hardware_counters\":[";
+    bool first = true;
+    for( std::size_t i = 0; i < num_hardware_events; ++i )
+    {
+        if( report.hardware_events_available[ i ] )
+        {
+            json << ( first ? "" : "," ) << '"' << ToString( static_cast< HardwareEvent >( i ) ) << '"';
+            first = false;
+        }
+    }
+    json << "],\"totals\":";
+    WriteThreadMetrics( json, report.totals, report.hardware_events_available );
+    json << ",\"memory\":";
+    WriteMemoryUsage( json, report.memory );
+    json << ",\"termination_layer\":" << report.termination_layer;
+    json << ",\"skyline_size\":[";
+    for( std::size_t i = 0; i < report.skyline_size.size(); ++i )
+    {
+        auto const& sample = report.skyline_size[ i ];
+        json << ( i ? "," : "" ) << "{\"us\":" << sample.elapsed_microseconds
+             << ",\"vertex\":" << sample.vertex
+             << ",\"size\":" << sample.skyline_size << "}";
+    }
+    json << "],\"per_thread\":[";
+    for( std::size_t i = 0; i < report.per_thread.size(); ++i )
+    {
+        json << ( i ? "," : "" );
+        WriteThreadMetrics( json, report.per_thread[ i ], report.hardware_events_available );
+    }
+    json << "]}";
+    return json.str();
+}
+
+} // namespace metrics
@@ -0,0 +1,434 @@
+/**
+ * Micro-benchmarks of the hot kernels over controlled, seeded synthetic inputs.
+ * Build in Release mode and run the "benchmarks" executable; pass --benchmark_filter=<regex>
+ * to restrict it to some kernels when measuring an optimisation before and after.
+ */
+
+#include <algorithm>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <set>
+
+#include <benchmark/benchmark.h>
+
+#include "dominance-tests.hpp"
+#include "dynamic-skyline.hpp"
+#include "graph.hpp"
+#include "graph-structural-operations.hpp"
+#include "group-store.hpp"
+#include "listing-cliques.hpp"
+#include "listing-cousins-first.hpp"
+#include "sky-layers.hpp"
+#include "spatial.hpp"
+
+namespace { // anonymous
+
+coordinate_t constexpr max_coordinate = 1000;
+
+/**
+ * Returns num_points labels with independent, uniformly distributed coordinates in [0, max_coordinate)
+ */
+auto IndependentLabels( std::size_t num_points, dimension_t num_dimensions, unsigned seed ) -> label_list_t
+{
+    std::mt19937 generator( seed );
+    std::uniform_int_distribution< coordinate_t > coordinate( 0, max_coordinate - 1 );
+
+    label_list_t labels( num_points, vertex_label_t( num_dimensions ) );
+    for( auto & label : labels )
+    {
+        std::generate( std::begin( label ), std::end( label ), [ & ]{ return coordinate( generator ); } );
+    }
+    return labels;
+}
+
+/**
+ * Returns num_points labels whose coordinates all sum to the same value, so that no two distinct points
+ * dominate each other. Dominance tests over them never exit early on a dominating point.
+ */
+auto AntiCorrelatedLabels( std::size_t num_points, dimension_t num_dimensions, unsigned seed ) -> label_list_t
+{
+    std::mt19937 generator( seed );
+    std::uniform_int_distribution< coordinate_t > coordinate( 0, max_coordinate );
+
+    label_list_t labels( num_points, vertex_label_t( num_dimensions ) );
+    for( auto & label : labels )
+    {
+        // split [0, max_coordinate] at num_dimensions - 1 random cut points
+        vertex_label_t cuts( num_dimensions - 1 );
+        std::generate( std::begin( cuts ), std::end( cuts ), [ & ]{ return coordinate( generator ); } );
+        cuts.push_back( max_coordinate );
+        std::sort( std::begin( cuts ), std::end( cuts ) );
+        std::adjacent_difference( std::cbegin( cuts ), std::cend( cuts ), std::begin( label ) );
+    }
+    return labels;
+}
+
+/**
+ * Partitions the points 0..num_groups*groupSize-1 into consecutive groups, each sorted lexicographically
+ * by label so that no point can be dominated by a later one in its group (the precondition of GroupDominanceTest)
+ */
+auto ConsecutiveGroups( std::size_t num_groups, int groupSize, label_list_t const& labels ) -> group_list_t
+{
+    group_list_t groups( num_groups );
+    for( std::size_t i = 0; i < num_groups; ++i )
+    {
+        groups[ i ].resize( groupSize );
+        std::iota( std::begin( groups[ i ] ), std::end( groups[ i ] ), static_cast< point_index_t >( i * groupSize ) );
+        std::sort( std::begin( groups[ i ] ), std::end( groups[ i ] )
+                 , [ & ]( point_index_t a, point_index_t b ){ return labels[ a ] < labels[ b ]; } );
+    }
+    return groups;
+}
+
+/**
+ * Returns a uniformly random simple graph with num_vertices vertices and (about) the given average degree.
+ * Neighbour lists are sorted in descending order, as they are after UpdateGraph.
+ */
+auto RandomGraph( vertex_id_t num_vertices, int average_degree, unsigned seed ) -> adjacency_list_t
+{
+    std::mt19937 generator( seed );
+    std::uniform_int_distribution< vertex_id_t > vertex( 0, num_vertices - 1 );
+
+    std::set< std::pair< vertex_id_t, vertex_id_t > > edge_set;
+    std::size_t const num_edges = static_cast< std::size_t >( num_vertices ) * average_degree / 2;
+    while( edge_set.size() < num_edges )
+    {
+        vertex_id_t const u = vertex( generator );
+        vertex_id_t const v = vertex( generator );
+        if( u != v )
+        {
+            edge_set.emplace( std::min( u, v ), std::max( u, v ) );
+        }
+    }
+
+    adjacency_list_t edges( num_vertices );
+    for( auto const& [ u, v ] : edge_set )
+    {
+        edges[ u ].push_back( v );
+        edges[ v ].push_back( u );
+    }
+    for( auto & neighbours : edges )
+    {
+        std::sort( std::begin( neighbours ), std::end( neighbours ), std::greater<>() );
+    }
+    return edges;
+}
+
+/**
+ * Returns a sorted list of size distinct vertex ids drawn from [0, universe)
+ */
+auto RandomSortedList( std::size_t size, vertex_id_t universe, unsigned seed ) -> vertex_list_t
+{
+    std::mt19937 generator( seed );
+    vertex_list_t all( universe );
+    std::iota( std::begin( all ), std::end( all ), 0 );
+
+    vertex_list_t sample;
+    sample.reserve( size );
+    std::sample( std::cbegin( all ), std::cend( all ), std::back_inserter( sample ), size, generator );
+    return sample; // std::sample preserves the relative order of the population
+}
+
+
+// Arguments: number of dimensions
+void BM_PointDominanceTest( benchmark::State & state )
+{
+    std::size_t constexpr num_points = 4096; // cycle through many points so branches are not memorised
+    auto const labels = IndependentLabels( num_points, state.range( 0 ), 1 );
+
+    std::size_t i = 0;
+    for( auto _ : state )
+    {
+        auto const& p = labels[ i % num_points ];
+        auto const& q = labels[ ( i + 1 ) % num_points ];
+        benchmark::DoNotOptimize( PointDominanceTest( std::cbegin( p ), std::cend( p ), std::cbegin( q ) ) );
+        ++i;
+    }
+    state.SetItemsProcessed( state.iterations() );
+}
+BENCHMARK( BM_PointDominanceTest )->DenseRange( 2, 8, 2 );
+
+
+// Arguments: group size, number of dimensions
+void BM_GroupDominanceTest( benchmark::State & state )
+{
+    std::size_t constexpr num_groups = 1024;
+    int const groupSize = state.range( 0 );
+    auto const labels = IndependentLabels( num_groups * groupSize, state.range( 1 ), 2 );
+    auto const groups = ConsecutiveGroups( num_groups, groupSize, labels );
+
+    std::size_t i = 0;
+    for( auto _ : state )
+    {
+        auto const& g1 = groups[ i % num_groups ];
+        auto const& g2 = groups[ ( i + 1 ) % num_groups ];
+        benchmark::DoNotOptimize( GroupDominanceTest( std::cbegin( g1 ), std::cend( g1 ), std::cbegin( g2 ), std::cend( g2 ), labels ) );
+        ++i;
+    }
+    state.SetItemsProcessed( state.iterations() );
+}
+BENCHMARK( BM_GroupDominanceTest )->ArgsProduct( { { 3, 5, 8, 12 }, { 2, 4, 6 } } );
+
+
+// Arguments: skyline size, group size. Every test scans the whole skyline because no group is dominated.
+void BM_IsDominatedBySkyline( benchmark::State & state )
+{
+    std::size_t const skyline_size = state.range( 0 );
+    int const groupSize = state.range( 1 );
+    dimension_t constexpr num_dimensions = 3;
+    auto const labels = AntiCorrelatedLabels( ( skyline_size + 1 ) * groupSize, num_dimensions, 3 );
+    auto groups = ConsecutiveGroups( skyline_size + 1, groupSize, labels );
+
+    GroupStore candidate( groupSize, num_dimensions );
+    candidate.Append( groups.back(), labels );
+    groups.pop_back();
+
+    GroupStore skyline( groupSize, num_dimensions );
+    for( auto const& group : groups )
+    {
+        skyline.Append( group, labels );
+    }
+
+    for( auto _ : state )
+    {
+        benchmark::DoNotOptimize( IsDominatedBySkyline( candidate, 0, skyline, labels ) );
+    }
+    state.SetItemsProcessed( state.iterations() * skyline_size );
+}
+BENCHMARK( BM_IsDominatedBySkyline )->ArgsProduct( { benchmark::CreateRange( 16, 4096, 4 ), { 3, 6 } } );
+
+
+// Arguments: size of the longer list, how many times shorter the other list is, kernel (see IntersectionKernel).
+// Lists are drawn from a universe four times as large as the longer one.
+void BM_GetIntersection( benchmark::State & state )
+{
+    std::size_t const size = state.range( 0 );
+    auto const group1 = RandomSortedList( size, 4 * size, 4 );
+    auto const group2 = RandomSortedList( std::max< std::size_t >( size / state.range( 1 ), 1 ), 4 * size, 5 );
+    auto const kernel = static_cast< IntersectionKernel >( state.range( 2 ) );
+    vertex_list_t result;
+
+    for( auto _ : state )
+    {
+        GetIntersection( group1, group2, result, kernel );
+        benchmark::DoNotOptimize( result.data() );
+    }
+    state.SetItemsProcessed( state.iterations() * ( group1.size() + group2.size() ) );
+}
+BENCHMARK( BM_GetIntersection )->ArgsProduct( { { 64, 1024, 16384 }, { 1, 64 }, { 0, 1, 2 } } );
+
+
+// Arguments: number of vertices, average degree, number of hops
+void BM_GetKHopNeighbourhood( benchmark::State & state )
+{
+    vertex_id_t const num_vertices = state.range( 0 );
+    auto const edges = RandomGraph( num_vertices, state.range( 1 ), 6 );
+    vertex_list_t const active_vertices( num_vertices, 1 );
+    int const num_hops = state.range( 2 );
+
+    // traverse from vertices spread over the first half of the order, like a query scan does
+    vertex_id_t u = 0;
+    for( auto _ : state )
+    {
+        benchmark::DoNotOptimize( GetKHopNeighbourhood( u, edges, active_vertices, num_hops ) );
+        u = ( u + 7919 ) % ( num_vertices / 2 );
+    }
+    state.SetItemsProcessed( state.iterations() );
+}
+BENCHMARK( BM_GetKHopNeighbourhood )->ArgsProduct( { { 1 << 14, 1 << 17 }, { 8, 32 }, { 1, 2 } } );
+
+
+// Arguments: number of vertices, average degree, k. Peels the whole graph to its maximum k-core.
+void BM_ShrinkToMaxKCoreVertices( benchmark::State & state )
+{
+    vertex_id_t const num_vertices = state.range( 0 );
+    auto const edges = RandomGraph( num_vertices, state.range( 1 ), 7 );
+    int const k = state.range( 2 );
+
+    for( auto _ : state )
+    {
+        state.PauseTiming();
+        auto [ sortedIndices, nodePosition, binBoundaries ] = BinSortByDegree( edges );
+        vertex_list_t in_maximal_kcore( num_vertices, 1 );
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize( ShrinkToMaxKCoreVertices( k, std::nullopt, edges, sortedIndices, nodePosition, binBoundaries, in_maximal_kcore ) );
+    }
+    state.SetItemsProcessed( state.iterations() * num_vertices );
+}
+BENCHMARK( BM_ShrinkToMaxKCoreVertices )->ArgsProduct( { { 1 << 14, 1 << 17 }, { 16 }, { 8, 12, 16 } } )->Unit( benchmark::kMillisecond );
+
+
+// Arguments: group size, k-plex size. Lists from the 2-hop neighbourhood of vertex 0 of a small, dense graph.
+void BM_ListKCoresWithPrefix( benchmark::State & state )
+{
+    vertex_id_t constexpr num_vertices = 48;
+    int const groupSize = state.range( 0 );
+    int const coreSize = groupSize - state.range( 1 ) - 1;
+    auto const edges = RandomGraph( num_vertices, 16, 8 );
+    vertex_list_t const nodes = GetKHopNeighbourhood( 0, edges, vertex_list_t( num_vertices, 1 ), 2 );
+
+    std::size_t num_groups = 0;
+    for( auto _ : state )
+    {
+        auto const groups = base::listing::cousins_first::ListKCoresWithPrefix( nodes, edges, groupSize, coreSize );
+        num_groups = groups.size();
+        benchmark::DoNotOptimize( groups.data() );
+    }
+    state.counters[ "groups" ] = num_groups;
+}
+BENCHMARK( BM_ListKCoresWithPrefix )->ArgsProduct( { { 3, 4, 5 }, { 1, 2 } } )->Unit( benchmark::kMicrosecond );
+
+
+// Arguments: clique size, clique kernel (0) or cousins-first listing (1). Lists from the neighbourhood of vertex 0 of a small, dense graph.
+void BM_ListCliquesWithPrefix( benchmark::State & state )
+{
+    vertex_id_t constexpr num_vertices = 48;
+    int const cliqueSize = state.range( 0 );
+    auto const edges = RandomGraph( num_vertices, 16, 8 );
+    auto const labels = IndependentLabels( num_vertices, 2, 9 );
+    vertex_list_t const nodes = GetKHopNeighbourhood( 0, edges, vertex_list_t( num_vertices, 1 ), 1 );
+    GroupStore cliques( cliqueSize, 2 );
+
+    for( auto _ : state )
+    {
+        cliques.clear();
+        if( state.range( 1 ) == 0 )
+        {
+            base::listing::cliques::ListCliquesWithPrefix( nodes, edges, cliqueSize, labels, cliques );
+        }
+        else
+        {
+            base::listing::cousins_first::ListKCoresWithPrefix( nodes, edges, cliqueSize, cliqueSize - 1, labels, cliques );
+        }
+        benchmark::DoNotOptimize( cliques.size() );
+    }
+    state.counters[ "groups" ] = cliques.size();
+}
+BENCHMARK( BM_ListCliquesWithPrefix )->ArgsProduct( { { 3, 4, 5 }, { 0, 1 } } )->Unit( benchmark::kMicrosecond );
+
+
+// Arguments: number of points, number of dimensions
+void BM_OrderByPartition( benchmark::State & state )
+{
+    std::size_t const num_points = state.range( 0 );
+    auto const labels = IndependentLabels( num_points, state.range( 1 ), 9 );
+
+    for( auto _ : state )
+    {
+        benchmark::DoNotOptimize( OrderByPartition( labels ) );
+    }
+    state.SetItemsProcessed( state.iterations() * num_points );
+}
+BENCHMARK( BM_OrderByPartition )->ArgsProduct( { { 1 << 12, 1 << 16 }, { 2, 4, 6 } } )->Unit( benchmark::kMillisecond );
+
+
+// Arguments: number of points, number of dimensions. Input is in the order produced by OrderByPartition.
+void BM_GenerateSkyLayers( benchmark::State & state )
+{
+    std::size_t const num_points = state.range( 0 );
+    auto const sorted_points = OrderByPartition( IndependentLabels( num_points, state.range( 1 ), 10 ) ).second;
+
+    for( auto _ : state )
+    {
+        benchmark::DoNotOptimize( GenerateSkyLayers( sorted_points ) );
+    }
+    state.SetItemsProcessed( state.iterations() * num_points );
+}
+BENCHMARK( BM_GenerateSkyLayers )->ArgsProduct( { { 1 << 12, 1 << 14 }, { 2, 4, 6 } } )->Unit( benchmark::kMillisecond );
+
+} // namespace anonymous
+
+// Arguments: number of edges per batch, whether to recompute the skyline from scratch instead. Each iteration
+// inserts a batch of random edges into a sparse graph and then deletes them again, updating the skyline of k=1, g=4.
+void BM_ApplyEdgeUpdates( benchmark::State & state )
+{
+    vertex_id_t const num_vertices = 1 << 13;
+    Graph graph;
+    graph.size = num_vertices;
+    graph.edges = RandomGraph( num_vertices, 12, 7 );
+    graph.labels = IndependentLabels( num_vertices, 3, 11 );
+    base::SkylineEngine const engine( std::move( graph ) );
+    base::SkylineQuery const query{ .kPlexSize = 1, .groupSize = 4, .algorithm = base::Algorithm::skcore, .nThreads = 1 };
+    base::DynamicSkyline skyline( engine, query );
+
+    std::mt19937 generator( 13 );
+    std::uniform_int_distribution< vertex_id_t > vertex( 0, num_vertices - 1 );
+    for( auto _ : state )
+    {
+        base::EdgeBatch insert;
+        while( insert.insertions.size() < static_cast< std::size_t >( state.range( 0 ) ) )
+        {
+            insert.insertions.emplace_back( vertex( generator ), vertex( generator ) );
+        }
+        base::EdgeBatch const remove{ {}, insert.insertions };
+
+        if( state.range( 1 ) )
+        {
+            benchmark::DoNotOptimize( engine.Query( query ) ); // the cost of answering each batch from scratch
+            benchmark::DoNotOptimize( engine.Query( query ) );
+        }
+        else
+        {
+            benchmark::DoNotOptimize( skyline.ApplyEdgeUpdates( insert ) );
+            benchmark::DoNotOptimize( skyline.ApplyEdgeUpdates( remove ) );
+        }
+    }
+    state.SetItemsProcessed( state.iterations() * 2 * state.range( 0 ) );
+}
+BENCHMARK( BM_ApplyEdgeUpdates )->ArgsProduct( { { 1, 16, 256 }, { 0, 1 } } )->Unit( benchmark::kMillisecond );
+
+// Arguments: number of label updates per batch, whether to preprocess the graph and recompute the skyline from scratch
+// instead. Each iteration moves the labels of random vertices by up to 1% of the range in each dimension, as drifting
+// attributes would, and then restores them.
+void BM_ApplyLabelUpdates( benchmark::State & state )
+{
+    vertex_id_t const num_vertices = 1 << 13;
+    Graph graph;
+    graph.size = num_vertices;
+    graph.edges = RandomGraph( num_vertices, 12, 7 );
+    graph.labels = IndependentLabels( num_vertices, 3, 11 );
+    Graph const original = graph;
+    base::SkylineEngine const engine( std::move( graph ) );
+    base::SkylineQuery const query{ .kPlexSize = 1, .groupSize = 4, .algorithm = base::Algorithm::skcore, .nThreads = 1 };
+    base::DynamicSkyline skyline( engine, query );
+
+    std::mt19937 generator( 13 );
+    std::uniform_int_distribution< vertex_id_t > vertex( 0, num_vertices - 1 );
+    std::uniform_int_distribution< coordinate_t > drift( -max_coordinate / 100, max_coordinate / 100 );
+    for( auto _ : state )
+    {
+        std::vector< base::LabelUpdate > update;
+        std::vector< base::LabelUpdate > restore;
+        while( update.size() < static_cast< std::size_t >( state.range( 0 ) ) )
+        {
+            vertex_id_t const target = vertex( generator );
+            vertex_label_t label = original.labels[ target ];
+            std::ranges::for_each( label, [ & ]( coordinate_t & x ){ x = std::clamp( x + drift( generator ), 0, max_coordinate - 1 ); } );
+            update.push_back( { target, std::move( label ) } );
+            restore.push_back( { target, original.labels[ target ] } );
+        }
+        std::ranges::reverse( restore );
+
+        if( state.range( 1 ) )
+        {
+            for( auto const* updates : { &update, &restore } ) // the cost of answering each batch from scratch
+            {
+                Graph updated = original;
+                for( auto const& [ target, label ] : *updates ) { updated.labels[ target ] = label; }
+                benchmark::DoNotOptimize( base::SkylineEngine( std::move( updated ) ).Query( query ) );
+            }
+        }
+        else
+        {
+            benchmark::DoNotOptimize( skyline.ApplyLabelUpdates( update ) );
+            benchmark::DoNotOptimize( skyline.ApplyLabelUpdates( restore ) );
+        }
+    }
+    state.SetItemsProcessed( state.iterations() * 2 * state.range( 0 ) );
+}
+BENCHMARK( BM_ApplyLabelUpdates )->ArgsProduct( { { 1, 16, 256 }, { 0, 1 } } )->Unit( benchmark::kMillisecond );
+
+
+BENCHMARK_MAIN();
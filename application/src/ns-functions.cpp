@@ -1,15 +1,22 @@
 #include <algorithm>
 #include <fstream>
+#include <limits>
+#include <numeric>
 #include <omp.h>
+#include <optional>
 #include <ranges>
 #include <tuple>
 
 #include "dominance-tests.hpp"
 #include "graph.hpp"
 #include "graph-structural-operations.hpp"
-#include "group-skyline-concepts.hpp"
+#include "group-store.hpp"
+#include "listing-cliques.hpp"
 #include "listing-cousins-first.hpp"
+#include "memory-accounting.hpp"
+#include "metrics.hpp"
 #include "postprocessing.hpp"
+#include "trace.hpp"
 
 #include "ns-functions.hpp"
 
@@ -29,41 +36,312 @@ auto GetLastGroup( Range range, vertex_id_t groupSize, ActiveSet const& is_activ
     return newGroup;
 }
 
+/**
+ * Returns an empty store for groups of the given size over the graph's labels
+ */
+auto MakeGroupStore( Graph const& myGraph, int groupSize ) -> GroupStore
+{
+    return GroupStore( groupSize, myGraph.labels.empty() ? 0 : myGraph.labels.front().size() );
+}
+
+/**
+ * Appends to candidates all groups of groupSize vertices and minimum degree coreSize that consist of
+ * nodes[0] and other vertices of nodes, taking the clique kernel if the query asks for cliques
+ */
+void ListCandidates( vertex_list_t const& nodes
+                   , adjacency_list_t const& edges
+                   , label_list_t const& labels
+                   , vertex_degree_t groupSize
+                   , vertex_degree_t coreSize
+                   , GroupStore & candidates )
+{
+    if( groupSize == coreSize + 1 )
+    {
+        base::listing::cliques::ListCliquesWithPrefix( nodes, edges, groupSize, labels, candidates );
+    }
+    else
+    {
+        base::listing::cousins_first::ListKCoresWithPrefix( nodes, edges, groupSize, coreSize, labels, candidates );
+    }
+}
+
 void UpdateSkyline( group_t const& candidate_group
                   , label_list_t const& labels
-                  , group_list_t & skylineCommunities
-                  , label_list_t & skylineRepresentatives )
+                  , GroupStore & skylineCommunities )
 {
     if( ! IsDominatedBySkyline( candidate_group, skylineCommunities, labels ) )
     {
-        skylineCommunities.push_back( candidate_group );
-        skylineRepresentatives.push_back(GetWorstVirtualPoint( candidate_group, labels ) );
+        skylineCommunities.Append( candidate_group, labels );
+    }
+}
+
+/**
+ * Streams the groups from position emitted onwards that are final to the sink; see EmitFinalGroups
+ */
+auto StreamFinalGroups( GroupStore const& skylineCommunities
+                      , std::size_t const emitted
+                      , label_list_t const& labels
+                      , GroupSink & sink
+                      , bool const is_complete ) -> std::size_t
+{
+    auto const resume = EmitFinalGroups( std::cbegin( skylineCommunities ) + emitted
+                                       , std::cend( skylineCommunities )
+                                       , labels
+                                       , [ &sink ]( GroupStore::group_view_t const group ){ sink.Write( group ); }
+                                       , is_complete );
+    return resume - std::cbegin( skylineCommunities );
+}
+
+/**
+ * Clears the flag of every candidate that is dominated by a candidate of a lower slot, i.e., one listed for a
+ * vertex earlier in the round, as a pairwise merge of the slots' candidate sets over ceil(log2(S)) levels: at the
+ * level of width w, the candidates of every odd block of w consecutive slots are tested against those of the block
+ * of w slots before it. Over all levels, every candidate thus meets the candidates of all lower slots, but the tests
+ * of each level are shared out among all threads rather than falling mostly to whoever holds the highest slot.
+ * Must be called by every thread of the team.
+ *
+ * @param offsets position of each slot's first candidate in flags, followed by the total number of candidates
+ */
+void FilterAcrossSlots( std::vector< GroupStore > const& candidates
+                        , intVec const& offsets
+                        , std::vector< char > & flags
+                        , label_list_t const& labels )
+{
+    int const num_slots = offsets.size() - 1;
+    int const num_candidates = offsets.back();
+    for( int width = 1; width < num_slots; width *= 2 )
+    {
+        #pragma omp for schedule( dynamic, 16 ) nowait
+        for( int g = 0; g < num_candidates; ++g )
+        {
+            int const owner = std::upper_bound( std::cbegin( offsets ), std::cend( offsets ), g ) - std::cbegin( offsets ) - 1;
+            int const block = owner / width;
+            if( block % 2 == 1 && flags[ g ] )
+            {
+                for( int peer = ( block - 1 ) * width; peer < block * width && flags[ g ]; ++peer )
+                {
+                    flags[ g ] = ! IsDominatedBySkyline( candidates[ owner ], g - offsets[ owner ], candidates[ peer ], labels );
+                }
+            }
+        }
+        {
+            trace::ScopedSpan span( "barrier:after_merge_level" );
+            #pragma omp barrier
+        }
+    }
+}
+
+/**
+ * Cheap upper bound on the work of listing the groups that start at a vertex: its number of active neighbours or,
+ * if groups can span two hops, that plus the degrees of those neighbours, capped by the number of remaining vertices
+ */
+auto EstimateCost( vertex_id_t const vertex
+                 , adjacency_list_t const& edges
+                 , vertex_list_t const& active_vertices
+                 , vertex_degree_t const num_hops
+                 , vertex_degree_t const num_remaining ) -> std::int64_t
+{
+    std::int64_t bound = 0;
+    for( vertex_id_t const neighbour : edges[ vertex ] )
+    {
+        if( active_vertices[ neighbour ] )
+        {
+            bound += num_hops > 1 ? 1 + GetDegree( edges, neighbour ) : 1;
+        }
     }
+    return 1 + std::min< std::int64_t >( bound, num_remaining );
 }
 
+/**
+ * Chooses the vertices that each round of the parallel driver processes. A round holds between one and
+ * max_vertices_per_thread vertices per thread. Within that range it grows to a target size, and beyond that for
+ * as long as its most expensive vertex would outlast all others together, so that the other threads have work
+ * while one processes a hub. The target doubles after a round that left the skyline unchanged, since candidates
+ * are then rarely filtered against a stale skyline, and halves after one that grew it.
+ */
+class RoundPlanner
+{
+public:
+
+    explicit RoundPlanner( std::size_t const nThreads )
+        : m_num_threads( nThreads )
+        , m_target( nThreads )
+    {}
+
+    void Clear()
+    {
+        m_vertices.clear();
+        m_costs.clear();
+        m_schedule.clear();
+    }
+
+    /**
+     * Plans a round of active vertices from next_vertex up to, but excluding, round_end,
+     * and advances next_vertex past the last vertex considered
+     */
+    void Plan( vertex_id_t & next_vertex
+             , vertex_id_t const round_end
+             , adjacency_list_t const& edges
+             , vertex_list_t const& active_vertices
+             , vertex_degree_t const num_hops
+             , vertex_degree_t const num_remaining
+             , std::size_t const skyline_size )
+    {
+        m_target = skyline_size == m_last_skyline_size ? std::min( 2 * m_target, m_num_threads * max_vertices_per_thread )
+                                                       : std::max( m_target / 2, m_num_threads );
+        m_last_skyline_size = skyline_size;
+        Clear();
+
+        std::int64_t total_cost = 0;
+        std::int64_t max_cost = 0;
+        for( ; next_vertex < round_end && m_vertices.size() < m_num_threads * max_vertices_per_thread; ++next_vertex )
+        {
+            if( active_vertices[ next_vertex ] )
+            {
+                if( m_vertices.size() >= m_target && total_cost >= static_cast< std::int64_t >( m_num_threads ) * max_cost )
+                {
+                    break;
+                }
+                std::int64_t const cost = EstimateCost( next_vertex, edges, active_vertices, num_hops, num_remaining );
+                m_vertices.push_back( next_vertex );
+                m_costs.push_back( cost );
+                total_cost += cost;
+                max_cost = std::max( max_cost, cost );
+            }
+        }
+
+        m_schedule.resize( m_vertices.size() );
+        std::iota( std::begin( m_schedule ), std::end( m_schedule ), 0lu );
+        std::ranges::stable_sort( m_schedule, std::ranges::greater{}, [ this ]( std::size_t const slot ){ return m_costs[ slot ]; } );
+    }
+
+    /**
+     * The vertices of the round in increasing order; the i'th is the round's i'th slot
+     */
+    auto GetVertices() const -> vertex_list_t const& { return m_vertices; }
+
+    /**
+     * The slots of the round, most expensive first
+     */
+    auto GetSchedule() const -> std::vector< std::size_t > const& { return m_schedule; }
+
+private:
+
+    static constexpr std::size_t max_vertices_per_thread = 16;
+
+    std::size_t m_num_threads;
+    std::size_t m_target;
+    std::size_t m_last_skyline_size = std::numeric_limits< std::size_t >::max(); // so that the first round has one vertex per thread
+    vertex_list_t m_vertices;
+    std::vector< std::int64_t > m_costs;
+    std::vector< std::size_t > m_schedule;
+};
+
+/**
+ * Ends the scan at any vertex rather than only at sky-layer boundaries. A group that the scan starts at vertex v
+ * has no member before v, so the best virtual point of the vertices from v onwards is no worse than any of its
+ * members; once the worst virtual point of a skyline group dominates that point, no group that remains can enter
+ * the skyline (see CanTerminate). A skyline group dominating the label of v alone would not suffice, since the
+ * other members of a group may be better than all of its members.
+ */
+class SuffixTermination
+{
+public:
+
+    /**
+     * Vertices that the query does not admit are left out of the suffix points, as no group can contain them
+     */
+    SuffixTermination( label_list_t const& labels, QueryContext const& context )
+        : m_num_dimensions( labels.empty() ? 0 : labels.front().size() )
+        , m_suffix_best( labels.size() * m_num_dimensions )
+    {
+        for( std::size_t v = labels.size(); v-- > 0; )
+        {
+            for( std::size_t d = 0; d < m_num_dimensions; ++d )
+            {
+                coordinate_t const later = v + 1 == labels.size()
+                    ? std::numeric_limits< coordinate_t >::max()
+                    : m_suffix_best[ ( v + 1 ) * m_num_dimensions + d ];
+                m_suffix_best[ v * m_num_dimensions + d ] = context.IsAdmitted( v ) ? std::min( labels[ v ][ d ], later ) : later;
+            }
+        }
+    }
+
+    /**
+     * Componentwise minimum of the labels of vertex and all vertices after it
+     */
+    auto GetSuffixBest( vertex_id_t const vertex ) const -> GroupStore::point_view_t
+    {
+        return { m_suffix_best.data() + vertex * m_num_dimensions, m_num_dimensions };
+    }
+
+    /**
+     * Whether no group of vertex and later vertices can enter the skyline. Skyline groups that did not dominate
+     * the suffix point in an earlier call are not tested again until the point changes, so a single-threaded scan
+     * can afford to ask at every vertex.
+     */
+    bool CanTerminate( vertex_id_t const vertex, GroupStore const& skyline )
+    {
+        auto const point = GetSuffixBest( vertex );
+        if( m_num_tested > 0 && ! std::ranges::equal( point, GetSuffixBest( m_tested_vertex ) ) )
+        {
+            m_num_tested = 0;
+        }
+        metrics::Add( metrics::Counter::suffix_termination_tests );
+        bool const can_terminate = ::CanTerminate( skyline, point, m_num_tested );
+        m_tested_vertex = vertex;
+        m_num_tested = skyline.size();
+        return can_terminate;
+    }
+
+    auto GetBytes() const -> std::int64_t { return memory::BytesOf( m_suffix_best ); }
+
+private:
+
+    std::size_t m_num_dimensions;
+    std::vector< coordinate_t > m_suffix_best; // m_num_dimensions per vertex
+    vertex_id_t m_tested_vertex = 0;           // vertex whose suffix point the first m_num_tested skyline groups do not dominate
+    std::size_t m_num_tested = 0;
+};
+
 } // namespace anonymous
 
 
 namespace base
 {
 
-auto InitialiseToMaxKCore( Graph & myGraph, int coreSize ) -> std::tuple< vertex_degree_t, vertex_list_t, vertex_list_t, vertex_list_t, vertex_list_t >
+auto InitialiseToMaxKCore( Graph const& myGraph, int coreSize, QueryContext const& context = {} ) -> std::tuple< vertex_degree_t, vertex_list_t, vertex_list_t, vertex_list_t, vertex_list_t >
 {
+    metrics::ScopedPhase phase( metrics::Phase::initial_peel );
     auto [ sortedIndices, nodePosition, binBoundaries ] =  BinSortByDegree( myGraph.edges );
     vertex_list_t in_maximal_kcore(myGraph.size, 1);
-    int num_remaining_vertices = myGraph.size - ShrinkToMaxKCoreVertices(coreSize, std::nullopt, myGraph.edges, sortedIndices, nodePosition, binBoundaries, in_maximal_kcore).first;
+    int num_pruned_vertices = ShrinkToMaxKCoreVertices(coreSize, std::nullopt, myGraph.edges, sortedIndices, nodePosition, binBoundaries, in_maximal_kcore).first;
+    int num_excluded_vertices = 0;
+
+    // Deactivate the vertices that the query excludes as if they had been peeled, so that their neighbours lose degree
+    for( vertex_id_t const vertex : std::views::iota( 0, context.admitted.empty() ? 0 : myGraph.size ) )
+    {
+        if( ! context.IsAdmitted( vertex ) && in_maximal_kcore[ vertex ] )
+        {
+            num_pruned_vertices += ShrinkToMaxKCoreVertices( coreSize, vertex, myGraph.edges, sortedIndices, nodePosition, binBoundaries, in_maximal_kcore ).first - 1;
+            ++num_excluded_vertices;
+        }
+    }
+    int num_remaining_vertices = myGraph.size - num_pruned_vertices - num_excluded_vertices;
+    metrics::Add( metrics::Counter::vertices_excluded_by_filter, num_excluded_vertices );
+    metrics::Add( metrics::Counter::vertices_pruned_by_kcore, num_pruned_vertices );
 
     return std::make_tuple( num_remaining_vertices, in_maximal_kcore, sortedIndices, nodePosition, binBoundaries );
 }
 
-bool CheckBoundaryCases( Graph & myGraph
+bool CheckBoundaryCases( Graph const& myGraph
                        , vertex_degree_t num_vertices
                        , vertex_id_t next_vertex
                        , int groupSize
                        , vertex_list_t const& in_maximal_kcore
-                       , group_list_t & skylineCommunities
-                       , label_list_t & skylineRepresentatives
-                       , int & layerNumber )
+                       , GroupStore & skylineCommunities
+                       , int & layerNumber
+                       , metrics::QueryRecord * const record )
 {
     if( num_vertices < groupSize ) // no remaining groups
     {
@@ -73,14 +351,16 @@ bool CheckBoundaryCases( Graph & myGraph
     {
         UpdateSkyline( GetLastGroup( std::views::iota( next_vertex, myGraph.size ), groupSize, in_maximal_kcore )
                      , myGraph.labels
-                     , skylineCommunities
-                     , skylineRepresentatives );
+                     , skylineCommunities );
         return true;
     }
     else if( next_vertex == myGraph.skyLayersBoundaries[ layerNumber ] )
     {
-        if( CanTerminate( skylineRepresentatives, myGraph.layerRepresentatives[ layerNumber ] ) )
+        metrics::RecordSkylineSize( record, next_vertex, skylineCommunities.size() );
+        if( CanTerminate( skylineCommunities, myGraph.layerRepresentatives[ layerNumber ] ) )
         {
+            metrics::Add( metrics::Counter::vertices_skipped_by_termination, num_vertices );
+            metrics::RecordTermination( record, layerNumber );
             return true;
         }
         else
@@ -97,21 +377,23 @@ auto FilterVertices( vertex_id_t next_vertex
                    , vertex_degree_t groupSize
                    , vertex_degree_t minCoreness
                    , vertex_list_t const& in_maximal_kcore
-                   , group_list_t & skylineCommunities
-                   , label_list_t & skylineRepresentatives ) -> vertex_list_t
+                   , GroupStore & skylineCommunities ) -> vertex_list_t
 {
-    vertex_list_t const nodes = GetKHopNeighbourhood( next_vertex
-                                                    , edges
-                                                    , in_maximal_kcore
-                                                    , groupSize - minCoreness == 1 ? 1 : 2 );
+    vertex_list_t const nodes = [ & ]
+    {
+        metrics::ScopedPhase phase( metrics::Phase::neighbourhood );
+        return GetKHopNeighbourhood( next_vertex
+                                   , edges
+                                   , in_maximal_kcore
+                                   , groupSize - minCoreness == 1 ? 1 : 2 );
+    }();
     if( nodes.size() == static_cast< size_t >( groupSize ) ) // if nodes is the only kcore connected group, check dominance
     {
         if( IsKCore(nodes, edges, minCoreness ) )
         {
             UpdateSkyline( nodes
                          , labels
-                         , skylineCommunities
-                         , skylineRepresentatives );
+                         , skylineCommunities );
         }
     }
 
@@ -123,68 +405,120 @@ void ListAndCheckGroups( vertex_list_t const& vertices
                        , label_list_t const& labels
                        , vertex_degree_t groupSize
                        , vertex_degree_t coreSize
-                       , group_list_t & skylineCommunities
-                       , label_list_t & skylineRepresentatives )
+                       , GroupStore & candidates
+                       , GroupStore & skylineCommunities )
 {
-    group_list_t candidates = listing::cousins_first::ListKCoresWithPrefix( vertices, edges, groupSize, coreSize );
+    candidates.clear();
+    {
+        metrics::ScopedPhase phase( metrics::Phase::listing );
+        vertex_list_t const feasible = ReduceToFeasibleCore( vertices, edges, groupSize, coreSize );
+        metrics::Add( metrics::Counter::vertices_pruned_by_structure, vertices.size() - feasible.size() );
+        ListCandidates( feasible, edges, labels, groupSize, coreSize, candidates );
+    }
+    metrics::Add( metrics::Counter::candidates_listed, candidates.size() );
+    memory::ScopedBytes const candidateBytes( memory::Subsystem::candidates, memory::BytesOf( candidates ) );
 
+    metrics::ScopedPhase phase( metrics::Phase::dominance_filtering );
     std::vector< bool > bIsSkyline( candidates.size(), true );
     for( size_t const i : std::views::iota( 0lu, candidates.size() ) )
     {
-        bIsSkyline[ i ] = !IsDominatedBySkyline(candidates[i], skylineCommunities, labels) && !IsDominatedByCandidates( i, candidates, bIsSkyline, labels );
+        bIsSkyline[ i ] = !IsDominatedBySkyline(candidates, i, skylineCommunities, labels) && !IsDominatedByCandidates( i, candidates, bIsSkyline, labels );
         if( bIsSkyline[ i ] ) 
         {
-            skylineCommunities.push_back(candidates[i]); // adding to skyline communitites
-            skylineRepresentatives.push_back(GetWorstVirtualPoint(candidates[i], labels));
+            skylineCommunities.Append(candidates, i); // adding to skyline communitites, along with their virtual points
         }
     }
 }
 
 namespace sequential
 {   
-    auto GetSkylineCommunities( Graph & myGraph, int coreSize, int groupSize ) -> group_list_t
+    auto GetSkylineCommunities( Graph const& myGraph, int coreSize, int groupSize, QueryContext const& context ) -> group_list_t
     {
-        group_list_t skylineCommunities;      // result set of skyline k-cores that will be built up
-        label_list_t skylineRepresentatives;  // maximum extent of each skyline k-core to be used for pruning
+        adjacency_list_t edges = myGraph.edges; // working copy that is shrunk as vertices are processed
+        memory::ScopedBytes const workingCopyBytes( memory::Subsystem::graph, memory::BytesOf( edges ) );
+        GroupStore skylineCommunities = MakeGroupStore( myGraph, groupSize ); // result set of skyline k-cores that will be built up,
+                                                                              // with the maximum extent of each to be used for pruning
+        GroupStore candidates = MakeGroupStore( myGraph, groupSize );         // reused for the groups listed for each vertex
         int layerNumber = 0;                  // counter for layers to detect when pruning conditions should be checked
+        std::size_t emitted = 0;              // number of skyline groups passed to the context's sink
+        std::optional< vertex_id_t > frontier; // the vertex at which the query ran out of budget, if it did
 
         // Initialise by computing maximal k-core and marking as false all vertices not in it
-        auto [ num_remaining_vertices, in_maximal_kcore, sortedIndices, nodePosition, binBoundaries ] = InitialiseToMaxKCore( myGraph, coreSize );
+        auto [ num_remaining_vertices, in_maximal_kcore, sortedIndices, nodePosition, binBoundaries ] = InitialiseToMaxKCore( myGraph, coreSize, context );
+        SuffixTermination suffixTermination( myGraph.labels, context );
+        memory::ScopedBytes const suffixBytes( memory::Subsystem::sky_layers, suffixTermination.GetBytes() );
 
         // iterate each sorted vertex and if it's still in the continually shrinking max k-core
         // list all k-cores involving it and higher-id vertices and check them against the skyline
         for ( vertex_id_t next_vertex : std::views::iota( 0, myGraph.size) )
         {
+            if( context.IsCancelled() )
+            {
+                break;
+            }
+            if( context.IsOverBudget( next_vertex ) )
+            {
+                frontier = next_vertex;
+                break;
+            }
+
             if( in_maximal_kcore[ next_vertex ] )
             {
-                if( CheckBoundaryCases( myGraph, num_remaining_vertices, next_vertex, groupSize, in_maximal_kcore, skylineCommunities, skylineRepresentatives, layerNumber ) )
+                if( CheckBoundaryCases( myGraph, num_remaining_vertices, next_vertex, groupSize, in_maximal_kcore, skylineCommunities, layerNumber, context.record ) )
+                {
+                    break;
+                }
+                if( suffixTermination.CanTerminate( next_vertex, skylineCommunities ) )
                 {
+                    metrics::Add( metrics::Counter::vertices_skipped_by_suffix, num_remaining_vertices );
+                    metrics::RecordTermination( context.record, layerNumber - 1 ); // the layer of next_vertex
                     break;
                 }
 
                 // Induce a sub-graph with this vertex to decrease listing time
-                auto const filtered_vertices = FilterVertices( next_vertex, myGraph.edges, myGraph.labels, groupSize, coreSize, in_maximal_kcore, skylineCommunities, skylineRepresentatives );
+                auto const filtered_vertices = FilterVertices( next_vertex, edges, myGraph.labels, groupSize, coreSize, in_maximal_kcore, skylineCommunities );
                 if( filtered_vertices.size() > static_cast< size_t >( groupSize ) )
                 {
                     // Update the skyline with all new groups involving this vertex
-                    ListAndCheckGroups( filtered_vertices, myGraph.edges, myGraph.labels, groupSize,  coreSize, skylineCommunities, skylineRepresentatives );
-                    num_remaining_vertices -= ShrinkToMaxKCoreVertices( coreSize, next_vertex, myGraph.edges, sortedIndices, nodePosition, binBoundaries, in_maximal_kcore ).first;
+                    ListAndCheckGroups( filtered_vertices, edges, myGraph.labels, groupSize,  coreSize, candidates, skylineCommunities );
                 }
+                // every group with next_vertex is known now, so it leaves the core, even if its neighbourhood held none,
+                // to keep the count of remaining vertices exact
+                int const num_removed_vertices = ShrinkToMaxKCoreVertices( coreSize, next_vertex, edges, sortedIndices, nodePosition, binBoundaries, in_maximal_kcore ).first;
+                num_remaining_vertices -= num_removed_vertices;
+                metrics::Add( metrics::Counter::vertices_pruned_by_kcore, num_removed_vertices - 1 ); // all but next_vertex itself
             }
             // else this vertex is not involved in any k-core groups.
 
-            RemoveVertex( myGraph.edges, next_vertex ); // physically update adjacency lists to shrink graph size
+            RemoveVertex( edges, next_vertex ); // physically update adjacency lists to shrink graph size
+
+            if( context.sink != nullptr )
+            {
+                emitted = StreamFinalGroups( skylineCommunities, emitted, myGraph.labels, *context.sink, false );
+            }
+        }
+        if( context.sink != nullptr && ! frontier )
+        {
+            StreamFinalGroups( skylineCommunities, emitted, myGraph.labels, *context.sink, true );
         }
 
-        // similar to remove-erase idiom; get rid of false positives
-        skylineCommunities.erase( postprocess( std::begin( skylineCommunities )
-                                             , std::end( skylineCommunities )
-                                             , myGraph.labels )
-                                , std::end( skylineCommunities ) );
-        return skylineCommunities;
+        // the skyline only grows until it is postprocessed, so this is its high-water mark
+        memory::ScopedBytes const skylineBytes( memory::Subsystem::skyline, memory::BytesOf( skylineCommunities ) );
+
+        // get rid of false positives, and of groups that the rest of the scan could have shown to be
+        metrics::ScopedPhase phase( metrics::Phase::postprocess );
+        if( frontier )
+        {
+            FinishPartialSkyline( skylineCommunities, emitted, myGraph.labels, *frontier, context );
+        }
+        else
+        {
+            postprocess( skylineCommunities, myGraph.labels );
+        }
+        return skylineCommunities.ToGroupList();
     }
 
-    auto GenerateSummerPlot( Graph & myGraph, int coreSize) -> std::vector<size_t>
+    auto GenerateSummerPlot( Graph const& myGraph, int coreSize) -> std::vector<size_t>
     {
         std::vector<size_t> vertex_count = {myGraph.size};
 
@@ -216,21 +550,30 @@ namespace sequential
 
 namespace parallel
 {
-    auto GetSkylineCommunities( Graph & myGraph, int coreSize, int groupSize, int nThreads ) -> group_list_t
+    auto GetSkylineCommunities( Graph const& myGraph, int coreSize, int groupSize, int nThreads, QueryContext const& context ) -> group_list_t
     {
-        group_list_t skylineCommunities;      // result set of skyline k-cores that will be built up
-        label_list_t skylineRepresentatives;  // maximum extent of each skyline k-core to be used for pruning
-        int layerNumber = 0;                  // counter for layers to detect when pruning conditions should be checked
+        adjacency_list_t edges = myGraph.edges; // working copy that is shrunk as vertices are processed
+        memory::ScopedBytes const workingCopyBytes( memory::Subsystem::graph, memory::BytesOf( edges ) );
+        GroupStore skylineCommunities = MakeGroupStore( myGraph, groupSize ); // result set of skyline k-cores that will be built up,
+                                                                              // with the maximum extent of each to be used for pruning
+        int layerNumber = 0;                  // next layer whose boundary is to be checked for termination
+        std::size_t emitted = 0;              // number of skyline groups passed to the context's sink
+        vertex_degree_t const num_hops = groupSize - coreSize == 1 ? 1 : 2;
 
         omp_set_num_threads( nThreads );
-        intVec threadWorkingIndex(nThreads);
-        std::vector<intVec2D> threadLocalCandidates(nThreads);
-        intVec threadLocalCandidatesNum(nThreads);
+        RoundPlanner planner( nThreads );
+        std::vector<GroupStore> slotCandidates;  // candidates listed for each vertex of the round, in order of vertex id
+        intVec slotPositions;                    // number of surviving candidates of each slot, then their position in the skyline
+        intVec candidateOffsets;                 // position of each slot's first candidate among those of all slots
+        std::vector< char > candidateIsSkyline;  // per candidate of any slot; not bools, as threads write neighbouring flags
         int bTerminate = false; // global early termination
+        std::optional< vertex_id_t > frontier; // the vertex at which the query ran out of budget, if it did
 
 
         // Initialise by computing maximal k-core and marking as false all vertices not in it
-        auto [ num_remaining_vertices, in_maximal_kcore, sortedIndices, nodePosition, binBoundaries ] = InitialiseToMaxKCore( myGraph, coreSize );
+        auto [ num_remaining_vertices, in_maximal_kcore, sortedIndices, nodePosition, binBoundaries ] = InitialiseToMaxKCore( myGraph, coreSize, context );
+        SuffixTermination suffixTermination( myGraph.labels, context );
+        memory::ScopedBytes const suffixBytes( memory::Subsystem::sky_layers, suffixTermination.GetBytes() );
 
         int indexToProcess = 0;
         int indexToRemove = 0;
@@ -241,13 +584,23 @@ namespace parallel
         {
             vertex_id_t const first_vertex_in_iteration = indexToProcess; // so we know later where to start edge removals from.
 
-            #pragma omp barrier
-            #pragma omp single
             {
-                std::fill(threadWorkingIndex.begin(), threadWorkingIndex.end(), myGraph.size);
+                trace::ScopedSpan span( "barrier:round_start" );
+                #pragma omp barrier
+            }
+            #pragma omp single nowait
+            {
+                trace::ScopedSpan span( "peel_and_assign" );
+                if( context.sink != nullptr )
+                {
+                    emitted = StreamFinalGroups( skylineCommunities, emitted, myGraph.labels, *context.sink, false );
+                }
+                planner.Clear();
                 while (indexToRemove < indexToProcess)
                 {
-                    num_remaining_vertices -= ShrinkToMaxKCoreVertices(coreSize, indexToRemove, myGraph.edges, sortedIndices, nodePosition, binBoundaries, in_maximal_kcore).first;
+                    int const num_removed_vertices = ShrinkToMaxKCoreVertices(coreSize, indexToRemove, edges, sortedIndices, nodePosition, binBoundaries, in_maximal_kcore).first;
+                    num_remaining_vertices -= num_removed_vertices;
+                    metrics::Add( metrics::Counter::vertices_pruned_by_kcore, std::max( 0, num_removed_vertices - 1 ) ); // all but indexToRemove itself
                     if (num_remaining_vertices < groupSize)
                     {
                         bTerminate = true;
@@ -255,143 +608,212 @@ namespace parallel
                     }
                     indexToRemove++;
                 }
+                bTerminate = bTerminate || context.IsCancelled();
+                if( ! bTerminate && context.IsOverBudget( indexToProcess ) ) // every earlier vertex has been processed
+                {
+                    frontier = indexToProcess;
+                    bTerminate = true;
+                }
                 if (!bTerminate)
                 {
                     if (num_remaining_vertices == groupSize)
                     {
                         UpdateSkyline( GetLastGroup( std::views::iota( indexToProcess, myGraph.size ), groupSize, in_maximal_kcore )
                                      , myGraph.labels
-                                     , skylineCommunities
-                                     , skylineRepresentatives );
+                                     , skylineCommunities );
                         bTerminate = true;
                     }
                     else
                     {
-                        int tID = 0;
-                        std::fill(threadWorkingIndex.begin(), threadWorkingIndex.end(), myGraph.size);
-                        while(tID < nThreads && indexToProcess < myGraph.size)
+                        // check every layer boundary that the scan has reached, so that no round spans an unchecked one
+                        while(myGraph.skyLayersBoundaries[layerNumber] <= indexToProcess && indexToProcess < myGraph.size)
                         {
-                            if (in_maximal_kcore[indexToProcess])
+                            metrics::RecordSkylineSize( context.record, myGraph.skyLayersBoundaries[layerNumber], skylineCommunities.size() );
+                            if (CanTerminate(skylineCommunities, myGraph.layerRepresentatives[layerNumber]))
                             {
-                                threadWorkingIndex[tID++] = indexToProcess++;
-                            }
-                            else
-                            {
-                                indexToProcess++;
-                            }
-                        }
-                        while(myGraph.skyLayersBoundaries[layerNumber] < indexToProcess && indexToProcess < myGraph.size)
-                        {
-                            if (CanTerminate(skylineRepresentatives, myGraph.layerRepresentatives[layerNumber]))
-                            {
-                                for (size_t id = 0; id < static_cast<size_t>(nThreads); id++)
-                                {
-                                    threadWorkingIndex[id] += myGraph.size * (threadWorkingIndex[id] >= myGraph.skyLayersBoundaries[layerNumber]);
-                                }
+                                metrics::Add( metrics::Counter::vertices_skipped_by_termination
+                                            , std::count( in_maximal_kcore.cbegin() + myGraph.skyLayersBoundaries[layerNumber], in_maximal_kcore.cend(), 1 ) );
+                                metrics::RecordTermination( context.record, layerNumber );
                                 bTerminate = true; // global
                                 break;
                             }
                             layerNumber++;
                         }
+                        if (!bTerminate && suffixTermination.CanTerminate(indexToProcess, skylineCommunities))
+                        {
+                            metrics::Add( metrics::Counter::vertices_skipped_by_suffix
+                                        , std::count( in_maximal_kcore.cbegin() + indexToProcess, in_maximal_kcore.cend(), 1 ) );
+                            metrics::RecordTermination( context.record, layerNumber - 1 ); // the layer of indexToProcess
+                            bTerminate = true;
+                        }
+                        if (!bTerminate)
+                        {
+                            // the round ends at the next layer boundary at the latest
+                            vertex_id_t const round_end = std::min( myGraph.skyLayersBoundaries[layerNumber], myGraph.size );
+                            planner.Plan( indexToProcess, round_end, edges, in_maximal_kcore, num_hops, num_remaining_vertices, skylineCommunities.size() );
+                            metrics::Add( metrics::Counter::parallel_rounds );
+                        }
                     }
                 }
+                std::size_t const num_slots = planner.GetVertices().size();
+                if( slotCandidates.size() < num_slots )
+                {
+                    slotCandidates.resize( num_slots, MakeGroupStore( myGraph, groupSize ) );
+                }
+                slotPositions.assign( num_slots, 0 );
+                candidateOffsets.assign( num_slots + 1, 0 );
+            }
+            {
+                trace::ScopedSpan span( "barrier:after_peel" );
+                #pragma omp barrier
             }
-            // implicit barrier
 
-            const size_t threadID = omp_get_thread_num();
-            const int index = threadWorkingIndex[threadID];
-            threadLocalCandidates[threadID].clear();
+            vertex_list_t const& roundVertices = planner.GetVertices();
+            std::size_t const num_slots = roundVertices.size();
 
-            if( index < myGraph.size && GetDegree( myGraph.edges, index ) >= coreSize )
+            // vertices are handed out most expensive first, so that cheap ones fill in around a hub
+            #pragma omp for schedule( dynamic, 1 ) nowait
+            for( std::size_t k = 0; k < num_slots; ++k )
             {
-                vertex_list_t const nodes = GetKHopNeighbourhood( index
-                                                , myGraph.edges
-                                                , in_maximal_kcore
-                                                , groupSize - coreSize == 1 ? 1 : 2 );
-                if (nodes.size() == static_cast< size_t >(groupSize) && IsKCore(nodes, myGraph.edges, coreSize) && !IsDominatedBySkyline(nodes, skylineCommunities, myGraph.labels)) // if nodes is the only kcore connected group
-                { 
-                    threadLocalCandidates[threadID].push_back(nodes);
-                }
-                else if (nodes.size() > static_cast< size_t >(groupSize))
-                {
-                    threadLocalCandidates[ threadID ] = listing::cousins_first::ListKCoresWithPrefix( nodes, myGraph.edges, groupSize, coreSize );
-                }
+                std::size_t const slot = planner.GetSchedule()[ k ];
+                vertex_id_t const index = roundVertices[ slot ];
+                GroupStore & candidates = slotCandidates[ slot ];
+                candidates.clear();
+                memory::ScopedBytes candidateBytes( memory::Subsystem::candidates );
 
-                std::vector< bool > bIsSkyline(threadLocalCandidates[threadID].size(), true);
-                for (size_t i = 0; i < threadLocalCandidates[threadID].size(); i++) // comparing to peers and known skylines
-                { 
-                    bIsSkyline[i] = !IsDominatedBySkyline(threadLocalCandidates[threadID][i], skylineCommunities, myGraph.labels) && !IsDominatedByCandidates(i, threadLocalCandidates[threadID], bIsSkyline, myGraph.labels);
-                }
-                for (int i = threadLocalCandidates[threadID].size() - 1; i >= 0; i--) // removing non-skyline candidates
-                { 
-                    if (!bIsSkyline[i])
+                if( GetDegree( edges, index ) >= coreSize )
+                {
+                    vertex_list_t const nodes = [ & ]
+                    {
+                        trace::ScopedSpan span( "neighbourhood", index );
+                        metrics::ScopedPhase phase( metrics::Phase::neighbourhood );
+                        vertex_list_t neighbourhood = GetKHopNeighbourhood( index
+                                                                          , edges
+                                                                          , in_maximal_kcore
+                                                                          , num_hops );
+                        span.SetSize( neighbourhood.size() );
+                        return neighbourhood;
+                    }();
+                    if (nodes.size() == static_cast< size_t >(groupSize) && IsKCore(nodes, edges, coreSize) && !IsDominatedBySkyline(nodes, skylineCommunities, myGraph.labels)) // if nodes is the only kcore connected group
+                    { 
+                        candidates.Append(nodes, myGraph.labels);
+                    }
+                    else if (nodes.size() > static_cast< size_t >(groupSize))
                     {
-                        threadLocalCandidates[threadID].erase(threadLocalCandidates[threadID].begin() + i);
+                        trace::ScopedSpan span( "listing", index, nodes.size() );
+                        metrics::ScopedPhase phase( metrics::Phase::listing );
+                        vertex_list_t const feasible = ReduceToFeasibleCore( nodes, edges, groupSize, coreSize );
+                        metrics::Add( metrics::Counter::vertices_pruned_by_structure, nodes.size() - feasible.size() );
+                        ListCandidates( feasible, edges, myGraph.labels, groupSize, coreSize, candidates );
+                        metrics::Add( metrics::Counter::candidates_listed, candidates.size() );
+                        candidateBytes.Set( memory::BytesOf( candidates ) );
+                    }
+
+                    trace::ScopedSpan span( "candidate_filtering", index, nodes.size() );
+                    metrics::ScopedPhase phase( metrics::Phase::dominance_filtering );
+                    std::vector< bool > bIsSkyline(candidates.size(), true);
+                    for (size_t i = 0; i < candidates.size(); i++) // comparing to peers and known skylines
+                    { 
+                        bIsSkyline[i] = !IsDominatedBySkyline(candidates, i, skylineCommunities, myGraph.labels) && !IsDominatedByCandidates(i, candidates, bIsSkyline, myGraph.labels);
                     }
+                    candidates.Compact(bIsSkyline); // removing non-skyline candidates
                 }
             }
-            #pragma omp barrier
+            {
+                trace::ScopedSpan span( "barrier:after_listing" );
+                #pragma omp barrier
+            }
 
-            intVec bIsSkyline(threadLocalCandidates[threadID].size(), true);
-            for (size_t i = 0; i < threadLocalCandidates[threadID].size(); i++) // comparing to potential skylines found by threads with lower IDs
+            #pragma omp single nowait
             {
-                for (size_t j = 0; j < threadID && bIsSkyline[i]; j++)
+                // number the candidates of all slots consecutively, in order of vertex id
+                for (size_t slot = 0; slot < num_slots; slot++)
                 {
-                    bIsSkyline[i] = !IsDominatedBySkyline(threadLocalCandidates[threadID][i], threadLocalCandidates[j], myGraph.labels);
+                    candidateOffsets[slot + 1] = candidateOffsets[slot] + slotCandidates[slot].size();
                 }
+                candidateIsSkyline.assign(candidateOffsets[num_slots], true);
+            }
+            {
+                trace::ScopedSpan span( "barrier:after_numbering" );
+                #pragma omp barrier
+            }
+            {
+                trace::ScopedSpan span( "cross_thread_filtering" );
+                metrics::ScopedPhase phase( metrics::Phase::dominance_filtering );
+                FilterAcrossSlots( slotCandidates, candidateOffsets, candidateIsSkyline, myGraph.labels );
             }
-            #pragma omp barrier
 
-            for (int i = threadLocalCandidates[threadID].size() - 1; i >= 0; i--) // removing non-skyline candidates
-            { 
-                if (!bIsSkyline[i])
-                {
-                    threadLocalCandidates[threadID].erase(threadLocalCandidates[threadID].begin() + i);
-                }
+            #pragma omp for schedule( dynamic, 1 ) nowait
+            for( std::size_t slot = 0; slot < num_slots; ++slot )
+            {
+                slotCandidates[slot].Compact( std::vector< bool >( candidateIsSkyline.cbegin() + candidateOffsets[slot]
+                                                                 , candidateIsSkyline.cbegin() + candidateOffsets[slot + 1] ) ); // removing non-skyline candidates
+                slotPositions[slot] = slotCandidates[slot].size();
+            }
+            {
+                trace::ScopedSpan span( "barrier:after_count" );
+                #pragma omp barrier
             }
-            threadLocalCandidatesNum[threadID] = threadLocalCandidates[threadID].size();
-            #pragma omp barrier 
 
-            #pragma omp single
+            #pragma omp single nowait
             {
+                trace::ScopedSpan span( "commit" );
+                // prefix sum of the numbers of survivors gives each slot the position of its groups in the skyline
                 int startPosition = skylineCommunities.size();
-                for (size_t tID = 0; tID < static_cast<size_t>(nThreads); tID++)
+                for (size_t slot = 0; slot < num_slots; slot++)
                 {
-                    const int tmp = threadLocalCandidatesNum[tID];
-                    threadLocalCandidatesNum[tID] = startPosition;
+                    const int tmp = slotPositions[slot];
+                    slotPositions[slot] = startPosition;
                     startPosition += tmp;
                 }
-                skylineCommunities.resize(startPosition);
-                skylineRepresentatives.resize(startPosition);
+                skylineCommunities.Resize(startPosition);
+            }
+            {
+                trace::ScopedSpan span( "barrier:after_commit" );
+                #pragma omp barrier
+            }
 
+            #pragma omp single nowait
+            {
+                trace::ScopedSpan span( "remove_vertices" );
                 // physically update adjacency lists to shrink graph size for all vertices in this batch iteration
                 std::ranges::for_each( std::views::iota( first_vertex_in_iteration
                                                        , std::min( indexToProcess, myGraph.size ) )
-                                     , [ &edges = myGraph.edges ]( vertex_id_t const vertex_to_remove )
+                                     , [ &edges ]( vertex_id_t const vertex_to_remove )
                                      {
                                         RemoveVertex( edges, vertex_to_remove );
                                      } );
             }
 
-            intVec2D representatives;
-            representatives.reserve(threadLocalCandidates[threadID].size());
-            for (const intVec& newSkyline : threadLocalCandidates[threadID]) // computing representatives
-            { 
-                representatives.push_back(GetWorstVirtualPoint(newSkyline, myGraph.labels));
+            trace::ScopedSpan span( "copy_to_skyline" );
+            #pragma omp for schedule( dynamic, 1 ) nowait
+            for( std::size_t slot = 0; slot < num_slots; ++slot )
+            {
+                skylineCommunities.Place(slotPositions[slot], slotCandidates[slot]); // representatives travel with the groups
             }
-            std::copy(threadLocalCandidates[threadID].cbegin(), threadLocalCandidates[threadID].cend(), skylineCommunities.begin() + threadLocalCandidatesNum[threadID]);
-            std::copy(representatives.cbegin(), representatives.cend(), skylineRepresentatives.begin() + threadLocalCandidatesNum[threadID]);
 
         } //  end of main for loop
         } // end of parallel region
+        if( context.sink != nullptr && ! frontier )
+        {
+            StreamFinalGroups( skylineCommunities, emitted, myGraph.labels, *context.sink, true );
+        }
 
 
-        // similar to remove-erase idiom; get rid of false positives
-        skylineCommunities.erase( postprocess( std::begin( skylineCommunities )
-                                             , std::end( skylineCommunities )
-                                             , myGraph.labels )
-                                , std::end( skylineCommunities ) );
-        return skylineCommunities;
+        // the skyline only grows until it is postprocessed, so this is its high-water mark
+        memory::ScopedBytes const skylineBytes( memory::Subsystem::skyline, memory::BytesOf( skylineCommunities ) );
+
+        // get rid of false positives, and of groups that the rest of the scan could have shown to be
+        metrics::ScopedPhase phase( metrics::Phase::postprocess );
+        if( frontier )
+        {
+            FinishPartialSkyline( skylineCommunities, emitted, myGraph.labels, *frontier, context );
+        }
+        else
+        {
+            postprocess( skylineCommunities, myGraph.labels );
+        }
+        return skylineCommunities.ToGroupList();
     } // end of function
 } // end of parallel namespace
 } // end of base namespace
\ No newline at end of file
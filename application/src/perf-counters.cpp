@@ -0,0 +1,130 @@
+#include "perf-counters.hpp"
+
+#ifdef __linux__
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace { // anonymous
+
+#ifdef __linux__
+
+auto ToPerfConfig( HardwareEvent const event ) -> std::uint64_t
+{
+    switch( event )
+    {
+        case HardwareEvent::cycles:        return PERF_COUNT_HW_CPU_CYCLES;
+        case HardwareEvent::instructions:  return PERF_COUNT_HW_INSTRUCTIONS;
+        case HardwareEvent::llc_misses:    return PERF_COUNT_HW_CACHE_MISSES;
+        case HardwareEvent::branch_misses: return PERF_COUNT_HW_BRANCH_MISSES;
+        case HardwareEvent::count_:        break;
+    }
+    return PERF_COUNT_HW_MAX;
+}
+
+/**
+ * Opens one counter for the calling thread, in the group of leader (or as a new group if leader < 0)
+ */
+int OpenCounter( HardwareEvent const event, int const leader )
+{
+    perf_event_attr attributes;
+    std::memset( &attributes, 0, sizeof( attributes ) );
+    attributes.type = PERF_TYPE_HARDWARE;
+    attributes.size = sizeof( attributes );
+    attributes.config = ToPerfConfig( event );
+    attributes.disabled = leader < 0 ? 1 : 0; // the leader starts the whole group at once
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+    attributes.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return static_cast< int >( syscall( SYS_perf_event_open, &attributes, 0, -1, leader, 0 ) );
+}
+
+#endif
+
+} // namespace anonymous
+
+
+auto ToString( HardwareEvent const event ) -> char const*
+{
+    switch( event )
+    {
+        case HardwareEvent::cycles:        return "cycles";
+        case HardwareEvent::instructions:  return "instructions";
+        case HardwareEvent::llc_misses:    return "llc_misses";
+        case HardwareEvent::branch_misses: return "branch_misses";
+        case HardwareEvent::count_:        break;
+    }
+    return "unknown";
+}
+
+PerfCounterGroup::PerfCounterGroup()
+{
+    m_fds.fill( -1 );
+
+#ifdef __linux__
+    for( std::size_t i = 0; i < num_hardware_events; ++i )
+    {
+        m_fds[ i ] = OpenCounter( static_cast< HardwareEvent >( i ), m_leader );
+        if( m_leader < 0 )
+        {
+            m_leader = m_fds[ i ];
+        }
+    }
+
+    if( m_leader >= 0 )
+    {
+        ioctl( m_leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP );
+        ioctl( m_leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP );
+    }
+#endif
+}
+
+PerfCounterGroup::~PerfCounterGroup()
+{
+#ifdef __linux__
+    for( int const fd : m_fds )
+    {
+        if( fd >= 0 )
+        {
+            close( fd );
+        }
+    }
+#endif
+}
+
+auto PerfCounterGroup::Read() const -> HardwareCounts
+{
+    HardwareCounts counts = {};
+
+#ifdef __linux__
+    if( m_leader < 0 )
+    {
+        return counts;
+    }
+
+    // layout for PERF_FORMAT_GROUP: number of events, time enabled, time running, then one value per open event
+    std::array< std::uint64_t, 3 + num_hardware_events > buffer = {};
+    if( read( m_leader, buffer.data(), sizeof( buffer ) ) <= 0 )
+    {
+        return counts;
+    }
+
+    std::uint64_t const time_enabled = buffer[ 1 ];
+    std::uint64_t const time_running = buffer[ 2 ];
+    double const scale = time_running > 0 ? static_cast< double >( time_enabled ) / time_running : 1.0;
+
+    for( std::size_t i = 0, value = 3; i < num_hardware_events; ++i )
+    {
+        if( m_fds[ i ] >= 0 )
+        {
+            counts[ i ] = static_cast< std::uint64_t >( buffer[ value++ ] * scale );
+        }
+    }
+#endif
+
+    return counts;
+}
@@ -0,0 +1,765 @@
+#include <boost/program_options.hpp> // for handling input arguments
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "skyline-engine.hpp"
+
+namespace { // anonymous
+
+const char* ARG_HELP    = "help,h";
+const char* ARG_SOCKET  = "socket,s";
+const char* ARG_THREADS = "threads,t";
+
+const char* USAGE = R"(Line protocol (one request per line, one JSON response per line):
+  load <graph> <edges-file> <labels-file> [<node-size>]
+  query <id> <graph> k=<k> g=<g> [algorithm=pkcore|skcore|baseline] [threads=<t>] [dims=<d1>,<d2>,...]
+        [where=<d>:<lower>:<upper>,...] [budget_ms=<ms>] [budget_vertices=<n>]
+  cancel <id>
+  unload <graph>
+  list
+  quit)";
+
+/**
+ * Escapes a string for inclusion in a JSON document
+ */
+auto JsonString( std::string const& text ) -> std::string
+{
+    std::string escaped = "\"";
+    for( char const c : text )
+    {
+        switch( c )
+        {
+            case '"':  escaped += "\\\""; break;
+            case '\\': escaped += "\\\\"; break;
+            case '\n': escaped += "\\n";  break;
+            case '\t': escaped += "\\t";  break;
+            default:   escaped += c;
+        }
+    }
+    return escaped + "\"";
+}
+
+auto JsonGroups( group_list_t const& groups ) -> std::string
+{
+    std::ostringstream json;
+    json << "[";
+    for( std::size_t i = 0; i < groups.size(); ++i )
+    {
+        json << ( i ? ",[" : "[" );
+        for( std::size_t j = 0; j < groups[ i ].size(); ++j )
+        {
+            json << ( j ? "," : "" ) << groups[ i ][ j ];
+        }
+        json << "]";
+    }
+    json << "]";
+    return json.str();
+}
+
+/**
+ * The fields of a query response that say whether its skyline is complete and, if not, how far it is
+ */
+auto JsonProgress( QueryProgress const& progress ) -> std::string
+{
+    if( progress.complete )
+    {
+        return R"(,"complete":true)";
+    }
+    return R"(,"complete":false,"scanned":)" + std::to_string( progress.scanned )
+         + R"(,"frontier":)" + std::to_string( progress.frontier )
+         + R"(,"layers_completed":)" + std::to_string( progress.layers_completed )
+         + R"(,"num_layers":)" + std::to_string( progress.num_layers );
+}
+
+auto ElapsedMilliseconds( std::chrono::steady_clock::time_point start ) -> long
+{
+    return std::chrono::duration_cast< std::chrono::milliseconds >( std::chrono::steady_clock::now() - start ).count();
+}
+
+/**
+ * Admission control for the threads used by concurrently running queries. Queries
+ * wait in arrival order until enough of the budget is free to run them, or until
+ * they are cancelled.
+ */
+class ThreadBudget
+{
+public:
+
+    explicit ThreadBudget( int capacity ) : m_available( capacity ), m_capacity( capacity ) {}
+
+    int GetCapacity() const { return m_capacity; }
+
+    /**
+     * Waits for n threads of the budget and takes them.
+     * @returns false, without taking any, if the token was cancelled while waiting
+     */
+    bool Acquire( int n, CancellationToken const& token )
+    {
+        std::unique_lock lock( m_mutex );
+        auto const ticket = m_nextTicket++;
+        m_changed.wait( lock, [ this, ticket, n, &token ]{ return token.IsCancelled() || ( ticket == m_nowServing && m_available >= n ); } );
+        bool const acquired = ! token.IsCancelled();
+        if( acquired )
+        {
+            m_available -= n;
+            ++m_nowServing;
+        }
+        else
+        {
+            m_abandoned.insert( ticket );
+        }
+        // the queries behind a cancelled one move up
+        while( m_abandoned.erase( m_nowServing ) )
+        {
+            ++m_nowServing;
+        }
+        m_changed.notify_all();
+        return acquired;
+    }
+
+    /**
+     * Wakes the waiting queries so that those whose token was cancelled since can give up their place
+     */
+    void Interrupt()
+    {
+        {
+            std::lock_guard lock( m_mutex );
+        }
+        m_changed.notify_all();
+    }
+
+    void Release( int n )
+    {
+        {
+            std::lock_guard lock( m_mutex );
+            m_available += n;
+        }
+        m_changed.notify_all();
+    }
+
+private:
+
+    std::mutex m_mutex;
+    std::condition_variable m_changed;
+    int m_available;
+    int const m_capacity;
+    unsigned long m_nextTicket = 0;
+    unsigned long m_nowServing = 0;
+    std::set< unsigned long > m_abandoned; // tickets of cancelled queries that are not served yet
+};
+
+/**
+ * Threads that are joined as soon as a later one is started after they finished, so that a
+ * long-running server does not accumulate them, and all at once when this is destroyed.
+ */
+class WorkerThreads
+{
+public:
+
+    ~WorkerThreads()
+    {
+        JoinAll();
+    }
+
+    template< typename Task >
+    void Start( Task task )
+    {
+        std::lock_guard lock( m_mutex );
+        JoinFinished();
+        // started under the lock, so that it is registered before it can report that it finished
+        std::thread worker( [ this, task = std::move( task ) ]() mutable
+        {
+            task();
+            std::lock_guard finished_lock( m_mutex );
+            m_finished.push_back( std::this_thread::get_id() );
+        } );
+        auto const id = worker.get_id();
+        m_threads.emplace( id, std::move( worker ) );
+    }
+
+    void JoinAll()
+    {
+        std::map< std::thread::id, std::thread > threads;
+        {
+            std::lock_guard lock( m_mutex );
+            threads.swap( m_threads );
+        }
+        for( auto & [ id, thread ] : threads )
+        {
+            thread.join();
+        }
+    }
+
+private:
+
+    void JoinFinished()
+    {
+        for( auto const id : m_finished )
+        {
+            if( auto const it = m_threads.find( id ); it != m_threads.end() )
+            {
+                it->second.join(); // only the destruction of its task is left
+                m_threads.erase( it );
+            }
+        }
+        m_finished.clear();
+    }
+
+    std::mutex m_mutex;
+    std::map< std::thread::id, std::thread > m_threads;
+    std::vector< std::thread::id > m_finished;
+};
+
+/**
+ * Where a session reads requests from and writes responses to
+ */
+class Channel
+{
+public:
+
+    virtual ~Channel() = default;
+    virtual bool ReadLine( std::string & line ) = 0;
+    virtual void WriteLine( std::string const& line ) = 0;
+};
+
+class StdioChannel : public Channel
+{
+public:
+
+    bool ReadLine( std::string & line ) override
+    {
+        return static_cast< bool >( std::getline( std::cin, line ) );
+    }
+
+    void WriteLine( std::string const& line ) override
+    {
+        std::lock_guard lock( m_mutex );
+        std::cout << line << std::endl;
+    }
+
+private:
+
+    std::mutex m_mutex;
+};
+
+/**
+ * The client sockets that are still open, so that quitting can wake up the sessions reading from them
+ */
+class OpenClients
+{
+public:
+
+    void Add( int fd )
+    {
+        std::lock_guard lock( m_mutex );
+        m_fds.insert( fd );
+    }
+
+    /**
+     * Closes a client socket; under the lock, so that its number cannot be reused by a client added meanwhile
+     */
+    void Close( int fd )
+    {
+        std::lock_guard lock( m_mutex );
+        m_fds.erase( fd );
+        close( fd );
+    }
+
+    void ShutdownAll()
+    {
+        std::lock_guard lock( m_mutex );
+        for( int const fd : m_fds )
+        {
+            shutdown( fd, SHUT_RD );
+        }
+    }
+
+private:
+
+    std::mutex m_mutex;
+    std::set< int > m_fds;
+};
+
+class SocketChannel : public Channel
+{
+public:
+
+    /**
+     * The socket stays open until the channel is destroyed, i.e., until the session and its queries are done with it
+     */
+    SocketChannel( int fd, std::shared_ptr< OpenClients > clients ) : m_fd( fd ), m_clients( std::move( clients ) ) {}
+
+    ~SocketChannel() override
+    {
+        m_clients->Close( m_fd );
+    }
+
+    bool ReadLine( std::string & line ) override
+    {
+        std::size_t newline;
+        while( ( newline = m_buffer.find( '\n' ) ) == std::string::npos )
+        {
+            char chunk[ 4096 ];
+            auto const bytes_read = read( m_fd, chunk, sizeof( chunk ) );
+            if( bytes_read <= 0 )
+            {
+                return false;
+            }
+            m_buffer.append( chunk, bytes_read );
+        }
+        line = m_buffer.substr( 0, newline );
+        m_buffer.erase( 0, newline + 1 );
+        return true;
+    }
+
+    void WriteLine( std::string const& line ) override
+    {
+        std::lock_guard lock( m_mutex );
+        std::string const message = line + "\n";
+        for( std::size_t written = 0; written < message.size(); )
+        {
+            auto const bytes_written = send( m_fd, message.data() + written, message.size() - written, MSG_NOSIGNAL );
+            if( bytes_written <= 0 )
+            {
+                return; // client went away; nothing left to tell it
+            }
+            written += bytes_written;
+        }
+    }
+
+private:
+
+    int const m_fd;
+    std::shared_ptr< OpenClients > const m_clients;
+    std::string m_buffer;
+    std::mutex m_mutex;
+};
+
+/**
+ * State shared by all sessions: the resident graphs, the running queries, and the thread budget
+ */
+class QueryServer
+{
+public:
+
+    explicit QueryServer( int nThreads ) : m_budget( nThreads ) {}
+
+    ~QueryServer()
+    {
+        // let outstanding queries report back before tearing down shared state
+        m_workers.JoinAll();
+    }
+
+    /**
+     * Processes requests from a channel until it is closed or asks to quit.
+     * @returns true if the client asked the whole server to quit
+     */
+    bool Serve( std::shared_ptr< Channel > const& channel )
+    {
+        std::string line;
+        while( channel->ReadLine( line ) )
+        {
+            std::istringstream request( line );
+            std::string command;
+            if( ! ( request >> command ) )
+            {
+                continue;
+            }
+
+            if( command == "quit" )
+            {
+                CancelAll(); // running queries may take hours; they report back as cancelled instead
+                channel->WriteLine( R"({"status":"ok","command":"quit"})" );
+                return true;
+            }
+
+            try
+            {
+                if     ( command == "load"   ) { Load( request, *channel ); }
+                else if( command == "unload" ) { Unload( request, *channel ); }
+                else if( command == "list"   ) { List( *channel ); }
+                else if( command == "query"  ) { StartQuery( request, channel ); }
+                else if( command == "cancel" ) { Cancel( request, *channel ); }
+                else
+                {
+                    throw std::invalid_argument( "unrecognised command: " + command );
+                }
+            }
+            catch( std::exception const& e )
+            {
+                channel->WriteLine( R"({"status":"error","command":)" + JsonString( command )
+                                  + R"(,"message":)" + JsonString( e.what() ) + "}" );
+            }
+        }
+        return false;
+    }
+
+private:
+
+    using EnginePointer = std::shared_ptr< base::SkylineEngine const >;
+
+    struct ResidentGraph
+    {
+        EnginePointer engine; // caches the engines of the subspaces queried so far
+    };
+
+    void Load( std::istringstream & request, Channel & channel )
+    {
+        std::string name, edgesFilePath, labelsFilePath;
+        if( ! ( request >> name >> edgesFilePath >> labelsFilePath ) )
+        {
+            throw std::invalid_argument( "usage: load <graph> <edges-file> <labels-file> [<node-size>]" );
+        }
+        std::optional< vertex_id_t > nodeSize; // detected from the files if not given
+        if( vertex_id_t size; request >> size )
+        {
+            nodeSize = size;
+        }
+
+        auto const start = std::chrono::steady_clock::now();
+        auto engine = std::make_shared< base::SkylineEngine const >( base::SkylineEngine::FromFiles( edgesFilePath, labelsFilePath, nodeSize ) );
+        {
+            std::lock_guard lock( m_mutex );
+            m_graphs[ name ] = ResidentGraph{ engine };
+        }
+
+        channel.WriteLine( R"({"status":"ok","command":"load","graph":)" + JsonString( name )
+                         + R"(,"vertices":)" + std::to_string( engine->GetGraph().size )
+                         + R"(,"time_ms":)" + std::to_string( ElapsedMilliseconds( start ) ) + "}" );
+    }
+
+    void Unload( std::istringstream & request, Channel & channel )
+    {
+        std::string name;
+        request >> name;
+        {
+            std::lock_guard lock( m_mutex );
+            if( m_graphs.erase( name ) == 0 )
+            {
+                throw std::invalid_argument( "unknown graph: " + name );
+            }
+        }
+        channel.WriteLine( R"({"status":"ok","command":"unload","graph":)" + JsonString( name ) + "}" );
+    }
+
+    void List( Channel & channel )
+    {
+        std::ostringstream json;
+        json << R"({"status":"ok","command":"list","graphs":[)";
+        {
+            std::lock_guard lock( m_mutex );
+            bool first = true;
+            for( auto const& [ name, graph ] : m_graphs )
+            {
+                json << ( first ? "" : "," ) << JsonString( name );
+                first = false;
+            }
+            json << R"(],"running":[)";
+            first = true;
+            for( auto const& [ id, token ] : m_running )
+            {
+                json << ( first ? "" : "," ) << JsonString( id );
+                first = false;
+            }
+        }
+        json << "]}";
+        channel.WriteLine( json.str() );
+    }
+
+    /**
+     * Raises the cancellation token of every running query and refuses new ones, so that the server can shut down
+     */
+    void CancelAll()
+    {
+        {
+            std::lock_guard lock( m_mutex );
+            m_quitting = true;
+            for( auto const& [ id, token ] : m_running )
+            {
+                token->Cancel();
+            }
+        }
+        m_budget.Interrupt();
+    }
+
+    void Cancel( std::istringstream & request, Channel & channel )
+    {
+        std::string id;
+        request >> id;
+        {
+            std::lock_guard lock( m_mutex );
+            auto const it = m_running.find( id );
+            if( it == m_running.end() )
+            {
+                throw std::invalid_argument( "no running query with id " + id );
+            }
+            it->second->Cancel();
+        }
+        m_budget.Interrupt();
+        channel.WriteLine( R"({"status":"ok","command":"cancel","id":)" + JsonString( id ) + "}" );
+    }
+
+    /**
+     * Parses a query request and hands it to a worker thread so that the session
+     * can keep accepting requests, e.g., to cancel it.
+     */
+    void StartQuery( std::istringstream & request, std::shared_ptr< Channel > const& channel )
+    {
+        std::string id, name;
+        if( ! ( request >> id >> name ) )
+        {
+            throw std::invalid_argument( "usage: query <id> <graph> k=<k> g=<g> [algorithm=...] [threads=<t>] [dims=...] [where=...] [budget_ms=<ms>] [budget_vertices=<n>]" );
+        }
+
+        base::SkylineQuery query;
+        query.kPlexSize = -1;
+        QueryBudget budget;                                  // the deadline is set once the query is running
+        std::optional< std::chrono::milliseconds > timeBudget;
+
+        std::string option;
+        while( request >> option )
+        {
+            auto const separator = option.find( '=' );
+            std::string const key   = option.substr( 0, separator );
+            std::string const value = separator == std::string::npos ? "" : option.substr( separator + 1 );
+
+            if     ( key == "k"       ) { query.kPlexSize = std::stoi( value ); }
+            else if( key == "g"       ) { query.groupSize = std::stoi( value ); }
+            else if( key == "threads" ) { query.nThreads = std::stoi( value ); }
+            else if( key == "algorithm" )
+            {
+                if     ( value == "pkcore"   ) { query.algorithm = base::Algorithm::pkcore; }
+                else if( value == "skcore"   ) { query.algorithm = base::Algorithm::skcore; }
+                else if( value == "baseline" ) { query.algorithm = base::Algorithm::baseline; }
+                else { throw std::invalid_argument( "unrecognised algorithm: " + value ); }
+            }
+            else if( key == "where" )
+            {
+                std::istringstream list( value );
+                std::string range;
+                while( std::getline( list, range, ',' ) )
+                {
+                    query.filter.ranges.push_back( base::ParseLabelRange( range ) );
+                }
+            }
+            else if( key == "dims" )
+            {
+                std::istringstream list( value );
+                std::string dimension;
+                while( std::getline( list, dimension, ',' ) )
+                {
+                    query.dimensions.push_back( std::stoi( dimension ) );
+                }
+            }
+            else if( key == "budget_ms"       ) { timeBudget = std::chrono::milliseconds( std::stoi( value ) ); }
+            else if( key == "budget_vertices" ) { budget.max_scanned = std::stoi( value ); }
+            else { throw std::invalid_argument( "unrecognised query option: " + key ); }
+        }
+
+        if( query.kPlexSize < 0 )
+        {
+            throw std::invalid_argument( "query requires k=<k>" );
+        }
+        if( auto const reason = base::ValidateQuery( query ); ! reason.empty() )
+        {
+            throw std::invalid_argument( reason );
+        }
+        query.nThreads = query.algorithm == base::Algorithm::pkcore ? std::min( query.nThreads, m_budget.GetCapacity() ) : 1;
+
+        auto token = std::make_shared< CancellationToken >();
+        EnginePointer engine;
+        {
+            std::lock_guard lock( m_mutex );
+            auto const graph = m_graphs.find( name );
+            if( graph == m_graphs.end() )
+            {
+                throw std::invalid_argument( "unknown graph: " + name );
+            }
+            if( m_quitting )
+            {
+                throw std::invalid_argument( "the server is shutting down" );
+            }
+            if( ! m_running.emplace( id, token ).second )
+            {
+                throw std::invalid_argument( "a query with id " + id + " is already running" );
+            }
+            engine = graph->second.engine;
+        }
+
+        m_workers.Start( [ this, id, query, engine, token, channel, budget, timeBudget ]
+        {
+            RunQuery( id, query, engine, *token, budget, timeBudget, *channel );
+            std::lock_guard lock( m_mutex );
+            m_running.erase( id );
+        } );
+    }
+
+    void RunQuery( std::string const& id
+                 , base::SkylineQuery const& query
+                 , EnginePointer const& engine
+                 , CancellationToken const& token
+                 , QueryBudget budget
+                 , std::optional< std::chrono::milliseconds > const timeBudget
+                 , Channel & channel )
+    {
+        auto const start = std::chrono::steady_clock::now();
+        std::string const prefix = R"({"id":)" + JsonString( id );
+
+        try
+        {
+            if( ! m_budget.Acquire( query.nThreads, token ) )
+            {
+                throw QueryCancelled();
+            }
+            auto const queued_ms = ElapsedMilliseconds( start );
+            if( timeBudget )
+            {
+                budget.deadline = std::chrono::steady_clock::now() + *timeBudget;
+            }
+            QueryProgress progress;
+            QueryContext const context{ .cancellation = &token, .budget = budget, .progress = &progress };
+
+            group_list_t communities;
+            try
+            {
+                communities = engine->Query( query, context );
+            }
+            catch( ... )
+            {
+                m_budget.Release( query.nThreads );
+                throw;
+            }
+            m_budget.Release( query.nThreads );
+
+            channel.WriteLine( prefix + R"(,"status":"ok","queued_ms":)" + std::to_string( queued_ms )
+                             + R"(,"time_ms":)" + std::to_string( ElapsedMilliseconds( start ) - queued_ms )
+                             + R"(,"num_groups":)" + std::to_string( communities.size() )
+                             + JsonProgress( progress )
+                             + R"(,"groups":)" + JsonGroups( communities ) + "}" );
+        }
+        catch( QueryCancelled const& )
+        {
+            channel.WriteLine( prefix + R"(,"status":"cancelled"})" );
+        }
+        catch( std::exception const& e )
+        {
+            channel.WriteLine( prefix + R"(,"status":"error","message":)" + JsonString( e.what() ) + "}" );
+        }
+    }
+
+    ThreadBudget m_budget;
+    std::mutex m_mutex;
+    std::map< std::string, ResidentGraph > m_graphs;
+    std::map< std::string, std::shared_ptr< CancellationToken > > m_running;
+    bool m_quitting = false; // set by quit, after which no query is started
+    WorkerThreads m_workers; // one per query
+};
+
+/**
+ * Accepts clients on a Unix domain socket, serving each on its own thread, until one asks to quit
+ */
+int ServeSocket( QueryServer & server, std::string const& socketPath )
+{
+    int const listener = socket( AF_UNIX, SOCK_STREAM, 0 );
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if( listener < 0 || socketPath.size() >= sizeof( address.sun_path ) )
+    {
+        std::cerr << "Could not create socket " << socketPath << std::endl;
+        return -1;
+    }
+    socketPath.copy( address.sun_path, socketPath.size() );
+    unlink( socketPath.c_str() );
+
+    if( bind( listener, reinterpret_cast< sockaddr const* >( &address ), sizeof( address ) ) < 0 || listen( listener, 16 ) < 0 )
+    {
+        std::cerr << "Could not listen on socket " << socketPath << std::endl;
+        close( listener );
+        return -1;
+    }
+    std::cout << "Listening on " << socketPath << std::endl;
+
+    // shared with the channels, which queries may hold on to after their session ended
+    auto const clients = std::make_shared< OpenClients >();
+    WorkerThreads sessions;
+    for( int client; ( client = accept( listener, nullptr, nullptr ) ) >= 0; )
+    {
+        clients->Add( client );
+        sessions.Start( [ &server, clients, listener, client ]
+        {
+            if( server.Serve( std::make_shared< SocketChannel >( client, clients ) ) )
+            {
+                // wake up accept() and every other session's read() so that the server can exit
+                shutdown( listener, SHUT_RDWR );
+                clients->ShutdownAll();
+            }
+        } );
+    }
+
+    sessions.JoinAll();
+    close( listener );
+    unlink( socketPath.c_str() );
+    return 0;
+}
+
+} // namespace anonymous
+
+int main (int argc, char** argv)
+{
+    std::string socket_path;
+    int num_threads = std::max( 1u, std::thread::hardware_concurrency() );
+
+    try
+    {
+        namespace po = boost::program_options;
+
+        po::options_description desc( std::string( "Resident skyline community query server\n\n" ) + USAGE + "\n\nOptions" );
+        desc.add_options()
+            (ARG_HELP,    "show usage instructions")
+            (ARG_SOCKET,  po::value<std::string>( &socket_path ), "serve clients on this Unix domain socket instead of stdin/stdout")
+            (ARG_THREADS, po::value<int>( &num_threads ), "total number of threads shared by all concurrently running queries")
+            ;
+
+        po::variables_map vm;
+        po::store( po::parse_command_line( argc, argv, desc ), vm );
+
+        if ( vm.count("help") )
+        {
+            std::cout << desc << std::endl;
+            return 0;
+        }
+        po::notify( vm );
+
+        if( num_threads < 1 )
+        {
+            std::cout << "Please specify a strictly positive number of threads." << std::endl;
+            return -1;
+        }
+
+        QueryServer server( num_threads );
+        if( socket_path.empty() )
+        {
+            server.Serve( std::make_shared< StdioChannel >() );
+            return 0;
+        }
+        return ServeSocket( server, socket_path );
+    }
+    catch ( std::exception const& e )
+    {
+        std::cerr << "error: " << e.what() << std::endl;
+        return 1;
+    }
+}
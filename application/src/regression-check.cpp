@@ -0,0 +1,477 @@
+/**
+ * Performance regression check over small, pinned, generated inputs. Runs every engine (and the parallel
+ * one at several thread counts) on each case and fails if
+ *   - any two runs of a case disagree on the skyline,
+ *   - a work counter (candidates listed, group or point dominance tests) grew past its recorded baseline, or
+ *   - a skyline maintained under random batches of edge or label updates differs from the skyline of the updated
+ *     graph, or the vertex order that it maintains is no longer valid.
+ * Counters do not depend on machine load, so unlike wall-clock thresholds they are stable on noisy machines.
+ */
+
+#include <boost/program_options.hpp> // for handling input arguments
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <random>
+#include <ranges>
+#include <set>
+#include <sstream>
+#include <utility>
+
+#include "dominance-tests.hpp"
+#include "dynamic-skyline.hpp"
+#include "generators.hpp"
+#include "metrics.hpp"
+#include "skyline-engine.hpp"
+
+namespace { // anonymous
+
+const char* ARG_HELP      = "help,h";
+const char* ARG_BASELINE  = "baseline,b";
+const char* ARG_RECORD    = "record";
+const char* ARG_TOLERANCE = "tolerance";
+
+enum class GraphModel
+{
+    rmat,
+    chung_lu,
+    planted
+};
+
+enum class LabelModel
+{
+    independent,
+    correlated,
+    anticorrelated
+};
+
+/**
+ * A pinned input and query. Inputs are generated from a fixed seed, so they never change.
+ */
+struct RegressionCase
+{
+    std::string name;
+    GraphModel graph;
+    vertex_id_t num_vertices;
+    double average_degree;
+    LabelModel labels;
+    dimension_t dimension;
+    int kPlexSize;
+    int groupSize;
+};
+
+std::vector< RegressionCase > const regression_cases = {
+    { "planted-indep-2d-clique",  GraphModel::planted,  3000, 12, LabelModel::independent,    2, 0, 4 },
+    { "planted-anticorr-2d-plex", GraphModel::planted,  1000,  8, LabelModel::anticorrelated, 2, 1, 4 },
+    { "chunglu-indep-3d-clique",  GraphModel::chung_lu, 3000, 10, LabelModel::independent,    3, 0, 3 },
+    { "chunglu-corr-2d-plex",     GraphModel::chung_lu, 3000, 10, LabelModel::correlated,     2, 1, 5 },
+    { "rmat-indep-3d-clique",     GraphModel::rmat,     2048,  6, LabelModel::independent,    3, 0, 4 },
+    { "rmat-indep-2d-plex",       GraphModel::rmat,     2048,  6, LabelModel::independent,    2, 1, 3 },
+};
+
+std::uint64_t constexpr regression_seed = 2030;
+std::vector< int > const regression_thread_counts = { 1, 2, 4 };
+
+/**
+ * The cases whose skylines are also maintained under updates; the others take too long to preprocess and query
+ * from scratch after every batch
+ */
+std::vector< std::string > const dynamic_case_names = { "planted-indep-2d-clique", "planted-anticorr-2d-plex", "chunglu-indep-3d-clique" };
+std::size_t constexpr num_update_batches = 3;
+std::size_t constexpr updates_per_batch = 40;
+std::size_t constexpr label_updates_per_batch = 4; // few enough that most batches reposition vertices rather than rebuild
+coordinate_t constexpr max_label_change = 5;
+
+/**
+ * The counters that measure work done; growth in any of them is a regression
+ */
+std::vector< metrics::Counter > const work_counters = { metrics::Counter::candidates_listed
+                                                      , metrics::Counter::group_dominance_tests
+                                                      , metrics::Counter::point_dominance_tests };
+
+auto MakeGraph( RegressionCase const& test ) -> Graph
+{
+    generators::edge_list_t edges;
+    switch( test.graph )
+    {
+        case GraphModel::rmat:     edges = generators::GenerateRmat( test.num_vertices, test.average_degree, {}, regression_seed ); break;
+        case GraphModel::chung_lu: edges = generators::GenerateChungLu( test.num_vertices, test.average_degree, 2.5, regression_seed ); break;
+        case GraphModel::planted:  edges = generators::GeneratePlantedCommunities( test.num_vertices, test.average_degree, test.num_vertices / 20, 0.1, regression_seed ); break;
+    }
+
+    Graph graph;
+    graph.size = test.num_vertices;
+    graph.edges = generators::ToAdjacencyList( edges, test.num_vertices );
+    switch( test.labels )
+    {
+        case LabelModel::independent:    graph.labels = generators::GenerateIndependentLabels( test.num_vertices, test.dimension, regression_seed ); break;
+        case LabelModel::correlated:     graph.labels = generators::GenerateCorrelatedLabels( test.num_vertices, test.dimension, regression_seed ); break;
+        case LabelModel::anticorrelated: graph.labels = generators::GenerateAnticorrelatedLabels( test.num_vertices, test.dimension, regression_seed ); break;
+    }
+    return graph;
+}
+
+auto MakeEngine( RegressionCase const& test ) -> base::SkylineEngine
+{
+    return base::SkylineEngine( MakeGraph( test ) );
+}
+
+/**
+ * Puts a skyline into a canonical form so that results of different engines can be compared
+ */
+auto Canonicalise( group_list_t groups ) -> group_list_t
+{
+    for( auto & group : groups )
+    {
+        std::sort( std::begin( group ), std::end( group ) );
+    }
+    std::sort( std::begin( groups ), std::end( groups ) );
+    return groups;
+}
+
+auto ToString( base::Algorithm const algorithm ) -> char const*
+{
+    switch( algorithm )
+    {
+        case base::Algorithm::skcore:   return "skcore";
+        case base::Algorithm::pkcore:   return "pkcore";
+        case base::Algorithm::baseline: return "baseline";
+    }
+    return "unknown";
+}
+
+/**
+ * The queries whose skylines are maintained under updates for a case: those of each engine that supports
+ * updates, with and without a vertex filter
+ */
+auto MakeDynamicQueries( RegressionCase const& test ) -> std::vector< base::SkylineQuery >
+{
+    std::vector< base::SkylineQuery > queries;
+    for( auto const& filter : { base::VertexFilter{}, base::VertexFilter{ .ranges = { { .dimension = 0, .lower = 20 } }, .vertices = std::nullopt } } )
+    {
+        queries.push_back( { .kPlexSize = test.kPlexSize, .groupSize = test.groupSize, .algorithm = base::Algorithm::skcore, .nThreads = 1, .filter = filter } );
+        queries.push_back( { .kPlexSize = test.kPlexSize, .groupSize = test.groupSize, .algorithm = base::Algorithm::pkcore, .nThreads = 2, .filter = filter } );
+    }
+    return queries;
+}
+
+/**
+ * Applies random batches of edge deletions and insertions to the skyline of a query, and counts the batches
+ * after which it differs from the skyline of an engine built on the updated graph from scratch. Each batch
+ * deletes edges at random vertices and closes triangles at others, so that groups both break and form.
+ */
+auto CountEdgeUpdateMismatches( RegressionCase const& test, base::SkylineQuery const& query ) -> int
+{
+    Graph graph = MakeGraph( test );
+    std::set< base::edge_t > edges; // each edge once, from its smaller endpoint
+    for( vertex_id_t const u : std::views::iota( 0, graph.size ) )
+    {
+        for( vertex_id_t const v : graph.edges[ u ] | std::views::filter( [ u ]( vertex_id_t const v ){ return u < v; } ) )
+        {
+            edges.emplace( u, v );
+        }
+    }
+
+    base::DynamicSkyline skyline( base::SkylineEngine( graph ), query );
+    std::mt19937_64 random( regression_seed );
+    std::uniform_int_distribution< vertex_id_t > AnyVertex( 0, graph.size - 1 );
+    auto const AnyNeighbour = [ & ]( vertex_id_t const u ){ return graph.edges[ u ][ random() % graph.edges[ u ].size() ]; };
+
+    int num_mismatches = 0;
+    for( std::size_t batch = 0; batch < num_update_batches; ++batch )
+    {
+        base::EdgeBatch updates;
+        for( std::size_t i = 0; i < updates_per_batch; ++i )
+        {
+            if( vertex_id_t const u = AnyVertex( random ); ! graph.edges[ u ].empty() )
+            {
+                updates.deletions.emplace_back( u, AnyNeighbour( u ) );
+            }
+            if( vertex_id_t const u = AnyVertex( random ); graph.edges[ u ].size() > 1 )
+            {
+                updates.insertions.emplace_back( AnyNeighbour( u ), AnyNeighbour( u ) );
+            }
+        }
+        for( auto const& [ u, v ] : updates.deletions )
+        {
+            edges.erase( std::minmax( u, v ) );
+        }
+        for( auto const& [ u, v ] : updates.insertions | std::views::filter( []( auto const& edge ){ return edge.first != edge.second; } ) )
+        {
+            edges.insert( std::minmax( u, v ) );
+        }
+        graph.edges = generators::ToAdjacencyList( { std::cbegin( edges ), std::cend( edges ) }, graph.size );
+
+        skyline.ApplyEdgeUpdates( updates );
+        if( Canonicalise( skyline.GetSkyline() ) != Canonicalise( base::SkylineEngine( graph ).Query( query ) ) )
+        {
+            ++num_mismatches;
+        }
+    }
+    return num_mismatches;
+}
+
+/**
+ * Whether a preprocessed graph is in the vertex order that the engines rely on: no vertex is dominated by one with
+ * a larger id, and vertices with equal labels are adjacent
+ */
+bool IsValidOrder( Graph const& graph )
+{
+    std::map< vertex_label_t, vertex_id_t > last_of_label;
+    for( vertex_id_t const vertex : std::views::iota( 0, graph.size ) )
+    {
+        auto const& label = graph.labels[ vertex ];
+        if( auto const [ last, is_new ] = last_of_label.try_emplace( label, vertex ); ! is_new && std::exchange( last->second, vertex ) != vertex - 1 )
+        {
+            return false;
+        }
+        for( vertex_id_t const later : std::views::iota( vertex + 1, graph.size ) )
+        {
+            auto const& later_label = graph.labels[ later ];
+            if( PointDominanceTest( std::cbegin( later_label ), std::cend( later_label ), std::cbegin( label ) ) == DominanceTestResult::dominates )
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * Applies random batches of label updates to the skyline of a query, and counts the batches after which it differs
+ * from the skyline of an engine built on the relabelled graph from scratch, or its vertex order is invalid. Half of
+ * the updates give a vertex the label of the one two places before it in the maintained order, so that it has to
+ * join that vertex even where the one in between would not make it move; the others change the label of a vertex
+ * a little. Both keep most vertices close to where they were, so that batches are mostly applied incrementally.
+ */
+auto CountLabelUpdateMismatches( RegressionCase const& test, base::SkylineQuery const& query ) -> int
+{
+    Graph graph = MakeGraph( test );
+    base::DynamicSkyline skyline( base::SkylineEngine( graph ), query );
+    std::mt19937_64 random( regression_seed );
+    std::uniform_int_distribution< vertex_id_t > AnyVertex( 0, graph.size - 1 );
+    std::uniform_int_distribution< coordinate_t > AnyChange( -max_label_change, max_label_change );
+
+    int num_mismatches = 0;
+    for( std::size_t batch = 0; batch < num_update_batches; ++batch )
+    {
+        std::vector< base::LabelUpdate > updates;
+        for( std::size_t i = 0; i < label_updates_per_batch; ++i )
+        {
+            vertex_id_t vertex = AnyVertex( random );
+            vertex_label_t label = graph.labels[ vertex ];
+            if( i % 2 == 0 )
+            {
+                auto const& maintained = skyline.GetGraph();
+                vertex_id_t const position = vertex % ( graph.size - 2 );
+                vertex = maintained.toOriginal[ position + 2 ];
+                label = graph.labels[ maintained.toOriginal[ position ] ];
+            }
+            else
+            {
+                std::ranges::for_each( label, [ & ]( coordinate_t & coordinate ){ coordinate += AnyChange( random ); } );
+            }
+            graph.labels[ vertex ] = label;
+            updates.push_back( { vertex, std::move( label ) } );
+        }
+
+        skyline.ApplyLabelUpdates( updates );
+        if( Canonicalise( skyline.GetSkyline() ) != Canonicalise( base::SkylineEngine( graph ).Query( query ) )
+         || ! IsValidOrder( skyline.GetGraph() ) )
+        {
+            ++num_mismatches;
+        }
+    }
+    return num_mismatches;
+}
+
+using counter_key_t = std::string; // case,algorithm,threads,counter
+using counter_map_t = std::map< counter_key_t, std::uint64_t >;
+
+auto MakeKey( RegressionCase const& test, base::SkylineQuery const& query, metrics::Counter const counter ) -> counter_key_t
+{
+    std::ostringstream key;
+    key << test.name << ',' << ToString( query.algorithm ) << ',' << query.nThreads << ',' << metrics::ToString( counter );
+    return key.str();
+}
+
+auto ReadBaseline( std::string const& filePath ) -> counter_map_t
+{
+    std::ifstream file( filePath );
+    if( ! file.is_open() )
+    {
+        throw std::runtime_error( "could not open baseline " + filePath );
+    }
+
+    counter_map_t baseline;
+    std::string line;
+    std::getline( file, line ); // header
+    while( std::getline( file, line ) )
+    {
+        auto const separator = line.rfind( ',' );
+        if( separator != std::string::npos )
+        {
+            baseline[ line.substr( 0, separator ) ] = std::stoull( line.substr( separator + 1 ) );
+        }
+    }
+    return baseline;
+}
+
+void WriteBaseline( std::string const& filePath, counter_map_t const& counters )
+{
+    std::ofstream file( filePath );
+    if( ! file.is_open() )
+    {
+        throw std::runtime_error( "could not write baseline " + filePath );
+    }
+
+    file << "case,algorithm,threads,counter,value\n";
+    for( auto const& [ key, value ] : counters )
+    {
+        file << key << ',' << value << '\n';
+    }
+}
+
+} // namespace anonymous
+
+int main (int argc, char** argv)
+{
+    std::string baseline_file;
+    std::string record_file;
+    double      tolerance;
+
+    try
+    {
+        namespace po = boost::program_options;
+
+        po::options_description desc("Execution arguments for checking engine consistency and work counters against a baseline");
+        desc.add_options()
+            (ARG_HELP, "show usage instructions")
+            (ARG_BASELINE,  po::value< std::string >( &baseline_file )->default_value( "../regression-baseline.csv" ), "counters to compare against")
+            (ARG_RECORD,    po::value< std::string >( &record_file ), "write the observed counters to this file as a new baseline instead of comparing")
+            (ARG_TOLERANCE, po::value< double >( &tolerance )->default_value( 0.05 ), "relative growth over the baseline that is still accepted")
+            ;
+
+        po::variables_map vm;
+        po::store( po::parse_command_line( argc, argv, desc ), vm );
+
+        // If someone needs help, nothing else matters.
+        if ( vm.count("help") )
+        {
+            std::cout << desc << std::endl;
+            return 0;
+        }
+        po::notify( vm );
+    }
+    catch( std::exception const& e )
+    {
+        std::cerr << "error: " << e.what() << std::endl;
+        return 1;
+    }
+
+#ifndef KSKYCORE_METRICS
+    std::cerr << "error: counters are only recorded when built with -DKSKYCORE_METRICS=ON" << std::endl;
+    return 1;
+#endif
+
+    try
+    {
+        counter_map_t const baseline = record_file.empty() ? ReadBaseline( baseline_file ) : counter_map_t{};
+        counter_map_t observed;
+        int num_failures = 0;
+
+        for( auto const& test : regression_cases )
+        {
+            base::SkylineEngine const engine = MakeEngine( test );
+
+            std::vector< base::SkylineQuery > queries = { { .kPlexSize = test.kPlexSize, .groupSize = test.groupSize, .algorithm = base::Algorithm::skcore, .nThreads = 1 } };
+            for( int const nThreads : regression_thread_counts )
+            {
+                queries.push_back( { .kPlexSize = test.kPlexSize, .groupSize = test.groupSize, .algorithm = base::Algorithm::pkcore, .nThreads = nThreads } );
+            }
+            if( test.kPlexSize == 0 )
+            {
+                queries.push_back( { .kPlexSize = test.kPlexSize, .groupSize = test.groupSize, .algorithm = base::Algorithm::baseline, .nThreads = 1 } );
+            }
+
+            std::optional< group_list_t > reference;
+            for( auto const& query : queries )
+            {
+                metrics::Reset();
+                auto const start = std::chrono::steady_clock::now();
+                auto const skyline = Canonicalise( engine.Query( query ) );
+                auto const elapsed = std::chrono::duration_cast< std::chrono::milliseconds >( std::chrono::steady_clock::now() - start );
+                auto const report = metrics::Collect();
+
+                std::cout << test.name << ' ' << ToString( query.algorithm ) << " threads=" << query.nThreads
+                          << ": " << skyline.size() << " groups in " << elapsed.count() << " ms";
+
+                if( ! reference )
+                {
+                    reference = skyline;
+                }
+                else if( skyline != *reference )
+                {
+                    std::cout << " MISMATCH (skcore found " << reference->size() << " groups)";
+                    ++num_failures;
+                }
+
+                for( auto const counter : work_counters )
+                {
+                    auto const key = MakeKey( test, query, counter );
+                    auto const value = report.totals.counters[ static_cast< std::size_t >( counter ) ];
+                    observed[ key ] = value;
+
+                    if( auto const it = baseline.find( key ); it != baseline.end() && value > it->second * ( 1 + tolerance ) )
+                    {
+                        std::cout << " REGRESSION " << metrics::ToString( counter ) << '=' << value << " (baseline " << it->second << ')';
+                        ++num_failures;
+                    }
+                    else if( it == baseline.end() && record_file.empty() )
+                    {
+                        std::cout << " (no baseline for " << metrics::ToString( counter ) << ')';
+                    }
+                }
+                std::cout << std::endl;
+            }
+        }
+
+        for( auto const& test : regression_cases | std::views::filter( []( auto const& test ){ return std::ranges::count( dynamic_case_names, test.name ) > 0; } ) )
+        {
+            for( auto const& query : MakeDynamicQueries( test ) )
+            {
+                std::cout << test.name << ' ' << ToString( query.algorithm ) << " threads=" << query.nThreads
+                          << ( query.filter.IsEmpty() ? "" : " filtered" );
+                char const* separator = ": ";
+                for( auto const& [ kind, CountMismatches ] : { std::pair{ "edge", &CountEdgeUpdateMismatches }, std::pair{ "label", &CountLabelUpdateMismatches } } )
+                {
+                    int const num_mismatches = CountMismatches( test, query );
+                    std::cout << std::exchange( separator, ", " ) << num_update_batches << " batches of " << kind << " updates";
+                    if( num_mismatches > 0 )
+                    {
+                        std::cout << " (MISMATCH after " << num_mismatches << ")";
+                    }
+                    num_failures += num_mismatches;
+                }
+                std::cout << std::endl;
+            }
+        }
+
+        if( ! record_file.empty() )
+        {
+            WriteBaseline( record_file, observed );
+            std::cout << "Recorded baseline to " << record_file << std::endl;
+        }
+
+        std::cout << ( num_failures == 0 ? "PASSED" : "FAILED" ) << std::endl;
+        return num_failures == 0 ? 0 : 1;
+    }
+    catch( std::exception const& e )
+    {
+        std::cerr << "error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,111 @@
+#include <charconv>
+
+#include "group-skyline-concepts.hpp"
+
+#include "result-writer.hpp"
+
+namespace { // anonymous
+
+std::size_t constexpr flush_threshold = 1 << 20; // bytes buffered before they are written to the stream
+
+template < typename T >
+void AppendRaw( std::string & buffer, T const value )
+{
+    buffer.append( reinterpret_cast< char const* >( &value ), sizeof( T ) );
+}
+
+void AppendNumber( std::string & buffer, int const number )
+{
+    char digits[ 16 ];
+    auto const end = std::to_chars( digits, digits + sizeof( digits ), number ).ptr;
+    buffer.append( digits, end );
+}
+
+} // namespace anonymous
+
+
+namespace base
+{
+
+ResultWriter::ResultWriter( std::ostream & out, Graph const& graph, ResultFormat const format, bool const attachLabels )
+    : m_out( out )
+    , m_graph( graph )
+    , m_format( format )
+    , m_attach_labels( attachLabels )
+{
+    if( m_format == ResultFormat::binary )
+    {
+        std::uint64_t const dimension = m_attach_labels && ! m_graph.labels.empty() ? m_graph.labels.front().size() : 0;
+        AppendRaw( m_buffer, dimension );
+    }
+}
+
+ResultWriter::~ResultWriter()
+{
+    Flush();
+}
+
+void ResultWriter::Write( std::span< vertex_id_t const > const group )
+{
+    if( m_format == ResultFormat::binary )
+    {
+        AppendRaw< std::uint32_t >( m_buffer, group.size() );
+        for( vertex_id_t const vertex : group )
+        {
+            AppendRaw< std::int32_t >( m_buffer, m_graph.toOriginal[ vertex ] );
+        }
+        if( m_attach_labels )
+        {
+            for( auto const& point : { GetBestVirtualPoint( group, m_graph.labels ), GetWorstVirtualPoint( group, m_graph.labels ) } )
+            {
+                for( coordinate_t const coordinate : point )
+                {
+                    AppendRaw< std::int32_t >( m_buffer, coordinate );
+                }
+            }
+        }
+    }
+    else
+    {
+        char separator = '\0';
+        auto const Append = [ this, &separator ]( int const number )
+        {
+            if( separator != '\0' )
+            {
+                m_buffer += separator;
+            }
+            AppendNumber( m_buffer, number );
+            separator = ',';
+        };
+        for( vertex_id_t const vertex : group )
+        {
+            Append( m_graph.toOriginal[ vertex ] );
+        }
+        if( m_attach_labels )
+        {
+            for( auto const& point : { GetBestVirtualPoint( group, m_graph.labels ), GetWorstVirtualPoint( group, m_graph.labels ) } )
+            {
+                for( coordinate_t const coordinate : point )
+                {
+                    Append( coordinate );
+                }
+            }
+        }
+        m_buffer += '\n';
+    }
+
+    ++m_num_groups;
+    if( m_buffer.size() >= flush_threshold )
+    {
+        Flush();
+    }
+}
+
+void ResultWriter::Flush()
+{
+    m_out.write( m_buffer.data(), m_buffer.size() );
+    m_out.flush();
+    m_buffer.clear();
+}
+
+} // namespace base
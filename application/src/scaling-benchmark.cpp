@@ -0,0 +1,334 @@
+/**
+ * Runs a sweep of skyline community queries (datasets x label types x d x k x g x algorithms x thread counts)
+ * with warm-up runs and repetitions, loading each graph only once, and writes one CSV row per configuration.
+ */
+
+#include <boost/program_options.hpp> // for handling input arguments
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <omp.h>
+#include <stdexcept>
+
+#include "datasets.hpp"
+#include "listing-cousins-first.hpp"
+#include "metrics.hpp"
+#include "skyline-engine.hpp"
+
+namespace { // anonymous
+
+const char* ARG_HELP        = "help,h";
+const char* ARG_DATASETS    = "datasets,D";
+const char* ARG_DIRECTORY   = "datasets-directory";
+const char* ARG_LABEL_TYPES = "label-types,l";
+const char* ARG_DIMENSIONS  = "dimensions,d";
+const char* ARG_KPLEX       = "k-plex,k";
+const char* ARG_GROUP       = "group-size,g";
+const char* ARG_ALGORITHMS  = "algorithms,a";
+const char* ARG_THREADS     = "threads,t";
+const char* ARG_WARMUP      = "warmup,w";
+const char* ARG_REPEAT      = "repetitions,r";
+const char* ARG_OUTPUT      = "output,o";
+
+/**
+ * The paths that can be swept: the three skyline algorithms, in the order of base::Algorithm,
+ * and plain listing of all size-g k-cores
+ */
+enum class Path
+{
+    skcore,
+    pkcore,
+    baseline,
+    listing
+};
+
+auto ToString( Path const path ) -> char const*
+{
+    switch( path )
+    {
+        case Path::skcore:   return "skcore";
+        case Path::pkcore:   return "pkcore";
+        case Path::baseline: return "baseline";
+        case Path::listing:  return "listing";
+    }
+    return "unknown";
+}
+
+auto ParsePath( std::string const& name ) -> Path
+{
+    for( Path const path : { Path::skcore, Path::pkcore, Path::baseline, Path::listing } )
+    {
+        if( name == ToString( path ) )
+        {
+            return path;
+        }
+    }
+    throw std::invalid_argument( "unknown algorithm " + name );
+}
+
+/**
+ * Returns the value below which a given fraction of the (sorted) samples fall, by linear interpolation
+ */
+auto Percentile( std::vector< double > const& sorted_samples, double const fraction ) -> double
+{
+    double const position = fraction * ( sorted_samples.size() - 1 );
+    std::size_t const lower = std::floor( position );
+    std::size_t const upper = std::ceil( position );
+    return sorted_samples[ lower ] + ( position - lower ) * ( sorted_samples[ upper ] - sorted_samples[ lower ] );
+}
+
+struct Configuration
+{
+    std::string dataset;
+    LabelType labelType;
+    dimension_t dimension;
+    int kPlexSize;
+    int groupSize;
+    Path path;
+    int nThreads;
+};
+
+void WriteHeader( std::ostream & csv )
+{
+    csv << "dataset,label_type,d,k,g,algorithm,threads,repetitions,"
+        << "median_ms,p10_ms,p90_ms,min_ms,max_ms,skyline_groups,termination_layer,peak_heap_bytes,peak_rss_kb";
+    for( std::size_t i = 0; i < metrics::num_counters; ++i )
+    {
+        csv << ',' << metrics::ToString( static_cast< metrics::Counter >( i ) );
+    }
+    csv << std::endl;
+}
+
+/**
+ * Runs one configuration warmup + repetitions times and writes its CSV row. Counters are those of the last repetition.
+ * The heap high-water mark is zero unless memory accounting is compiled in; the peak RSS is that of the whole sweep so far.
+ */
+void RunConfiguration( Configuration const& config
+                     , base::SkylineEngine const& engine
+                     , int const warmup
+                     , int const repetitions
+                     , std::ostream & csv )
+{
+    std::size_t num_groups = 0;
+    metrics::QueryRecord record;
+    auto const Run = [ & ]
+    {
+        if( config.path == Path::listing )
+        {
+            int const coreSize = config.groupSize - config.kPlexSize - 1;
+            num_groups = base::listing::cousins_first::ListAllKCores( engine.GetGraph().edges, config.groupSize, coreSize ).size();
+        }
+        else
+        {
+            base::SkylineQuery const query{ .kPlexSize = config.kPlexSize
+                                          , .groupSize = config.groupSize
+                                          , .algorithm = static_cast< base::Algorithm >( config.path )
+                                          , .nThreads = config.nThreads };
+            record = {};
+            QueryContext context;
+            context.record = &record;
+            num_groups = engine.Query( query, context ).size();
+        }
+    };
+
+    for( int i = 0; i < warmup; ++i )
+    {
+        Run();
+    }
+
+    std::vector< double > times_ms;
+    for( int i = 0; i < repetitions; ++i )
+    {
+        metrics::Reset();
+        auto const start = std::chrono::steady_clock::now();
+        Run();
+        times_ms.push_back( std::chrono::duration< double, std::milli >( std::chrono::steady_clock::now() - start ).count() );
+    }
+    std::sort( std::begin( times_ms ), std::end( times_ms ) );
+    auto const report = metrics::Collect( &record );
+
+    csv << config.dataset << ',' << ToString( config.labelType ) << ',' << config.dimension << ','
+        << config.kPlexSize << ',' << config.groupSize << ',' << ToString( config.path ) << ',' << config.nThreads << ','
+        << repetitions << ',' << Percentile( times_ms, 0.5 ) << ',' << Percentile( times_ms, 0.1 ) << ','
+        << Percentile( times_ms, 0.9 ) << ',' << times_ms.front() << ',' << times_ms.back() << ','
+        << num_groups << ',' << report.termination_layer << ',' << report.memory.heap.peak_bytes << ',' << report.memory.peak_rss_kb;
+    for( auto const count : report.totals.counters )
+    {
+        csv << ',' << count;
+    }
+    csv << std::endl;
+}
+
+} // namespace anonymous
+
+int main (int argc, char** argv)
+{
+    std::vector< int >         datasets;
+    std::string                datasets_directory;
+    std::vector< int >         label_types;
+    std::vector< dimension_t > dimensions;
+    std::vector< int >         kplex_sizes;
+    std::vector< int >         group_sizes;
+    std::vector< std::string > algorithm_names;
+    std::vector< int >         thread_counts;
+    int                        warmup;
+    int                        repetitions;
+    std::string                output_file;
+
+    try
+    {
+        namespace po = boost::program_options;
+
+        po::options_description desc("Execution arguments for sweeping skyline community queries");
+        desc.add_options()
+            (ARG_HELP, "show usage instructions")
+            (ARG_DATASETS,    po::value< std::vector< int > >( &datasets )->multitoken()->required(), "dataset ids; 4:YouTube, 5:case study, 10:LiveJournal, 11:DBLP, 12:Amazon, 13:WikiTalk, 14:CitPatent")
+            (ARG_DIRECTORY,   po::value< std::string >( &datasets_directory )->default_value( default_datasets_directory ), "directory holding the edge and label files")
+            (ARG_LABEL_TYPES, po::value< std::vector< int > >( &label_types )->multitoken()->default_value( { 0 }, "0" ), "label types; 0:indep, 1:corr, 2:anti-corr")
+            (ARG_DIMENSIONS,  po::value< std::vector< dimension_t > >( &dimensions )->multitoken()->required(), "label dimensionalities")
+            (ARG_KPLEX,       po::value< std::vector< int > >( &kplex_sizes )->multitoken()->required(), "k of the k-plex")
+            (ARG_GROUP,       po::value< std::vector< int > >( &group_sizes )->multitoken()->required(), "number of vertices in each group")
+            (ARG_ALGORITHMS,  po::value< std::vector< std::string > >( &algorithm_names )->multitoken()->default_value( { "pkcore" }, "pkcore" ), "algorithms; choices are: {skcore, pkcore, baseline, listing}")
+            (ARG_THREADS,     po::value< std::vector< int > >( &thread_counts )->multitoken(), "thread counts for pkcore (default: 1, 2, 4, ... up to the number of cores)")
+            (ARG_WARMUP,      po::value< int >( &warmup )->default_value( 1 ), "untimed runs before the repetitions")
+            (ARG_REPEAT,      po::value< int >( &repetitions )->default_value( 5 ), "timed runs per configuration")
+            (ARG_OUTPUT,      po::value< std::string >( &output_file ), "CSV file to write (default: standard output)")
+            ;
+
+        po::variables_map vm;
+        po::store( po::parse_command_line( argc, argv, desc ), vm );
+
+        // If someone needs help, nothing else matters.
+        if ( vm.count("help") || argc == 1 )
+        {
+            std::cout << desc << std::endl;
+            return 0;
+        }
+        po::notify( vm );
+    }
+    catch( std::exception const& e )
+    {
+        std::cerr << "error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    if( repetitions < 1 || warmup < 0 )
+    {
+        std::cerr << "error: need at least one repetition and a non-negative number of warm-up runs" << std::endl;
+        return 1;
+    }
+    if( thread_counts.empty() )
+    {
+        for( int t = 1; t <= omp_get_num_procs(); t *= 2 )
+        {
+            thread_counts.push_back( t );
+        }
+        if( thread_counts.back() != omp_get_num_procs() )
+        {
+            thread_counts.push_back( omp_get_num_procs() );
+        }
+    }
+
+    std::vector< Path > paths;
+    try
+    {
+        std::ranges::transform( algorithm_names, std::back_inserter( paths ), ParsePath );
+    }
+    catch( std::exception const& e )
+    {
+        std::cerr << "error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::ofstream output;
+    if( ! output_file.empty() )
+    {
+        output.open( output_file );
+    }
+    std::ostream & csv = output_file.empty() ? std::cout : output;
+    WriteHeader( csv );
+
+    for( int const datasetId : datasets )
+    {
+        auto const dataset = GetDataset( datasetId );
+        if( ! dataset )
+        {
+            std::cerr << "skipping invalid dataset " << datasetId << std::endl;
+            continue;
+        }
+
+        Graph base_graph;
+        try
+        {
+            if( ! LoadEdges( datasets_directory + dataset->edgesFile, base_graph.edges, dataset->nodeSize ) )
+            {
+                continue;
+            }
+        }
+        catch( std::runtime_error const& e ) // a corrupt binary header
+        {
+            std::cerr << "skipping dataset " << datasetId << ": " << e.what() << std::endl;
+            continue;
+        }
+
+        bool listed = false; // listing ignores labels, so only run it for the first labelling of a dataset
+        for( int const labelType : label_types )
+        {
+            for( dimension_t const dimension : dimensions )
+            {
+                Graph graph = base_graph;
+                bool loaded = false;
+                try
+                {
+                    loaded = labelType >= 0 && labelType <= 2
+                          && LoadLabels( datasets_directory + GetLabelsFile( static_cast< LabelType >( labelType ), dimension ), graph.labels, dataset->nodeSize );
+                }
+                catch( std::runtime_error const& e ) // a corrupt binary header
+                {
+                    std::cerr << e.what() << std::endl;
+                }
+                if( ! loaded )
+                {
+                    std::cerr << "skipping label type " << labelType << " with d=" << dimension << std::endl;
+                    continue;
+                }
+                base::SkylineEngine const engine( std::move( graph ) );
+                std::cerr << "loaded " << dataset->name << " with " << ToString( static_cast< LabelType >( labelType ) ) << ' ' << dimension << "-d labels" << std::endl;
+
+                for( int const kPlexSize : kplex_sizes )
+                {
+                    for( int const groupSize : group_sizes )
+                    {
+                        for( Path const path : paths )
+                        {
+                            if( path == Path::listing && listed )
+                            {
+                                continue;
+                            }
+
+                            // only the parallel algorithm is swept over thread counts
+                            std::vector< int > const threads = path == Path::pkcore ? thread_counts : std::vector< int >{ 1 };
+                            for( int const nThreads : threads )
+                            {
+                                Configuration const config{ dataset->name, static_cast< LabelType >( labelType ), dimension, kPlexSize, groupSize, path, nThreads };
+                                // listing has the same constraints on k and g as the skyline algorithms
+                                auto const algorithm = path == Path::listing ? base::Algorithm::pkcore : static_cast< base::Algorithm >( path );
+                                if( auto const reason = base::ValidateQuery( { .kPlexSize = kPlexSize, .groupSize = groupSize, .algorithm = algorithm, .nThreads = nThreads } ); ! reason.empty() )
+                                {
+                                    std::cerr << "skipping " << ToString( path ) << " with k=" << kPlexSize << " g=" << groupSize << " threads=" << nThreads << ": " << reason << std::endl;
+                                    continue;
+                                }
+                                RunConfiguration( config, engine, warmup, repetitions, csv );
+                            }
+                        }
+                    }
+                }
+                listed = true;
+            }
+        }
+    }
+
+    return 0;
+}
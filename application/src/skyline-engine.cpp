@@ -0,0 +1,369 @@
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <ranges>
+#include <stdexcept>
+
+#include "ns-functions.hpp"
+#include "zhang19.hpp"
+
+#include "skyline-engine.hpp"
+
+namespace { // anonymous
+
+/**
+ * Passes on the groups of a subspace engine in the vertex ids of the engine it was derived from,
+ * so that the caller's sink need not know which subspace answered the query
+ */
+class ToParentIds : public GroupSink
+{
+public:
+
+    ToParentIds( GroupSink & sink, Graph const& subspace, Graph const& parent )
+        : m_sink( sink )
+        , m_subspace( subspace )
+        , m_parent( parent )
+    {}
+
+    void Write( std::span< vertex_id_t const > group ) override
+    {
+        m_group.resize( group.size() );
+        std::ranges::transform( group, std::begin( m_group ), [ this ]( vertex_id_t const vertex )
+        {
+            return m_parent.toRelabelled[ m_subspace.toOriginal[ vertex ] ];
+        } );
+        m_sink.Write( m_group );
+    }
+
+private:
+
+    GroupSink & m_sink;
+    Graph const& m_subspace;
+    Graph const& m_parent;
+    vertex_list_t m_group;
+};
+
+/**
+ * Whether dimensions name all dimensions of the labels in their original order, i.e., no subspace at all
+ */
+bool IsFullSpace( std::vector< dimension_t > const& dimensions, Graph const& myGraph )
+{
+    dimension_t const num_dimensions = myGraph.labels.empty() ? 0 : myGraph.labels.front().size();
+    return dimensions.size() == static_cast< std::size_t >( num_dimensions )
+        && std::ranges::equal( dimensions, std::views::iota( 0, num_dimensions ) );
+}
+
+/**
+ * Completes the progress of a query, which an engine records in positions of the scan order only if it stopped early
+ */
+void DescribeProgress( QueryProgress & progress, Graph const& myGraph )
+{
+    progress.num_layers = myGraph.layerRepresentatives.size();
+    if( progress.complete )
+    {
+        progress.scanned = myGraph.size;
+        progress.frontier = -1;
+        progress.layers_completed = progress.num_layers;
+        return;
+    }
+    auto const& boundaries = myGraph.skyLayersBoundaries; // the first is always 0, and the others are where each layer ends
+    progress.frontier = myGraph.toOriginal[ progress.scanned ];
+    progress.layers_completed = std::upper_bound( std::cbegin( boundaries ) + 1, std::cend( boundaries ), progress.scanned )
+                              - ( std::cbegin( boundaries ) + 1 );
+}
+
+} // namespace anonymous
+
+
+namespace base
+{
+
+/**
+ * The subspace engines derived from an engine, keyed by their dimensions. Engines are built
+ * outside the lock, so that a query need not wait for another subspace to be preprocessed.
+ */
+class SkylineEngine::SubspaceCache
+{
+public:
+
+    struct Entry
+    {
+        std::shared_ptr< SkylineEngine const > engine;
+        std::uint64_t last_use; // value of uses when the entry was last returned
+    };
+
+    std::mutex mutex;
+    std::map< std::vector< dimension_t >, Entry > engines;
+    std::uint64_t uses = 0;
+};
+
+SkylineEngine::SkylineEngine( Graph graph )
+    : myGraph( std::move( graph ) )
+    , m_subspaces( std::make_shared< SubspaceCache >() )
+{
+    UpdateGraph( myGraph );
+}
+
+auto SkylineEngine::FromFiles( std::string const& edgesFilePath
+                             , std::string const& labelsFilePath
+                             , std::optional< vertex_id_t > nodeSize ) -> SkylineEngine
+{
+    Graph graph;
+    if( ! LoadGraph( edgesFilePath, labelsFilePath, graph, nodeSize ) )
+    {
+        throw std::runtime_error( "could not load graph from " + edgesFilePath + " and " + labelsFilePath );
+    }
+    return SkylineEngine( std::move( graph ) );
+}
+
+auto SkylineEngine::Query( SkylineQuery const& query, QueryContext const& context ) const -> group_list_t
+{
+    if( auto const reason = ValidateQuery( query ); ! reason.empty() )
+    {
+        throw std::invalid_argument( reason );
+    }
+
+    if( ! query.dimensions.empty() && ! IsFullSpace( query.dimensions, myGraph ) )
+    {
+        auto const subspace = GetSubspace( query.dimensions );
+        SkylineQuery projected = query;
+        projected.dimensions.clear();
+        if( context.sink == nullptr )
+        {
+            return subspace->Query( projected, context );
+        }
+        ToParentIds relay( *context.sink, subspace->GetGraph(), myGraph );
+        QueryContext relayed = context;
+        relayed.sink = &relay;
+        return subspace->Query( projected, relayed );
+    }
+
+    int const coreSize = query.GetCoreSize();
+    group_list_t communities;
+
+    std::vector< char > admitted;
+    QueryContext filteredContext = context;
+    if( ! query.filter.IsEmpty() )
+    {
+        admitted = GetAdmittedVertices( query.filter, myGraph );
+        filteredContext.admitted = admitted;
+    }
+
+    if( context.progress != nullptr )
+    {
+        *context.progress = QueryProgress{};
+    }
+
+    switch( query.algorithm )
+    {
+        case Algorithm::skcore:
+            communities = sequential::GetSkylineCommunities( myGraph, coreSize, query.groupSize, filteredContext );
+            break;
+        case Algorithm::pkcore:
+            communities = parallel::GetSkylineCommunities( myGraph, coreSize, query.groupSize, query.nThreads, filteredContext );
+            break;
+        case Algorithm::baseline:
+            zhang::GetSkylineCommunities( myGraph, coreSize, query.groupSize, communities, filteredContext );
+            break;
+    }
+
+    if( context.IsCancelled() )
+    {
+        throw QueryCancelled{};
+    }
+    if( context.progress != nullptr )
+    {
+        DescribeProgress( *context.progress, myGraph );
+    }
+    if( context.sink != nullptr ) // the groups have already been streamed
+    {
+        return {};
+    }
+
+    return ToOriginalIds( std::move( communities ), myGraph );
+}
+
+auto SkylineEngine::Subspace( std::vector< dimension_t > const& dimensions ) const -> SkylineEngine
+{
+    dimension_t const num_dimensions = myGraph.labels.empty() ? 0 : myGraph.labels.front().size();
+    if( dimensions.empty()
+     || std::ranges::any_of( dimensions, [ num_dimensions ]( auto const d ){ return d < 0 || d >= num_dimensions; } ) )
+    {
+        throw std::invalid_argument( "invalid subspace dimensions" );
+    }
+
+    // Preprocess the projected graph afresh in the ids of this engine, then compose its mapping with ours
+    Graph graph;
+    graph.size = myGraph.size;
+    graph.edges = myGraph.edges;
+    graph.labels.resize( myGraph.size );
+    for( vertex_id_t const vertex : std::views::iota( 0, myGraph.size ) )
+    {
+        auto & label = graph.labels[ vertex ];
+        label.reserve( dimensions.size() );
+        std::ranges::transform( dimensions
+                              , std::back_inserter( label )
+                              , [ &coordinates = myGraph.labels[ vertex ] ]( dimension_t const d ){ return coordinates[ d ]; } );
+    }
+
+    SkylineEngine subspace( std::move( graph ) );
+    Graph & projected = subspace.myGraph;
+    for( vertex_id_t const vertex : std::views::iota( 0, projected.size ) )
+    {
+        projected.toOriginal[ vertex ] = myGraph.toOriginal[ projected.toOriginal[ vertex ] ];
+        projected.toRelabelled[ projected.toOriginal[ vertex ] ] = vertex;
+    }
+    return subspace;
+}
+
+auto SkylineEngine::GetSubspace( std::vector< dimension_t > const& dimensions ) const -> std::shared_ptr< SkylineEngine const >
+{
+    auto & cache = *m_subspaces;
+    {
+        std::lock_guard lock( cache.mutex );
+        if( auto const subspace = cache.engines.find( dimensions ); subspace != cache.engines.end() )
+        {
+            subspace->second.last_use = ++cache.uses;
+            return subspace->second.engine;
+        }
+    }
+
+    auto subspace = std::make_shared< SkylineEngine const >( Subspace( dimensions ) );
+
+    std::lock_guard lock( cache.mutex );
+    if( auto const cached = cache.engines.find( dimensions ); cached != cache.engines.end() ) // another query was first
+    {
+        cached->second.last_use = ++cache.uses;
+        return cached->second.engine;
+    }
+    if( cache.engines.size() == max_cached_subspaces ) // queries still running on the evicted engine keep it alive
+    {
+        cache.engines.erase( std::ranges::min_element( cache.engines, {}, []( auto const& entry ){ return entry.second.last_use; } ) );
+    }
+    return cache.engines.emplace( dimensions, SubspaceCache::Entry{ std::move( subspace ), ++cache.uses } ).first->second.engine;
+}
+
+auto ValidateQuery( SkylineQuery const& query ) -> std::string
+{
+    int const coreSize = query.GetCoreSize();
+
+    if( query.groupSize > 2 * coreSize + 1 || query.groupSize <= coreSize )
+    {
+        return "invalid k and/or g parameters";
+    }
+    if( query.algorithm == Algorithm::pkcore && query.nThreads < 1 )
+    {
+        return "invalid number of threads";
+    }
+    if( query.algorithm == Algorithm::baseline && query.kPlexSize != 0 )
+    {
+        return "baseline only supports cliques, i.e., k = 0";
+    }
+    if( query.algorithm == Algorithm::baseline && ! query.filter.IsEmpty() )
+    {
+        return "baseline does not support vertex filters";
+    }
+    if( std::ranges::any_of( query.filter.ranges, []( LabelRange const& range ){ return range.lower > range.upper; } ) )
+    {
+        return "empty label range";
+    }
+    if( query.algorithm != Algorithm::skcore
+     && query.algorithm != Algorithm::pkcore
+     && query.algorithm != Algorithm::baseline )
+    {
+        return "invalid algorithm";
+    }
+    return "";
+}
+
+auto GetAdmittedVertices( VertexFilter const& filter, Graph const& myGraph ) -> std::vector< char >
+{
+    dimension_t const num_dimensions = myGraph.labels.empty() ? 0 : myGraph.labels.front().size();
+    if( std::ranges::any_of( filter.ranges, [ num_dimensions ]( LabelRange const& range ){ return range.dimension < 0 || range.dimension >= num_dimensions; } ) )
+    {
+        throw std::invalid_argument( "invalid label range dimension" );
+    }
+
+    std::vector< char > admitted( myGraph.size, 1 );
+    if( filter.vertices.has_value() )
+    {
+        std::ranges::fill( admitted, 0 );
+        for( vertex_id_t const original : *filter.vertices )
+        {
+            if( original < 0 || original >= myGraph.size )
+            {
+                throw std::invalid_argument( "vertex filter names unknown vertex " + std::to_string( original ) );
+            }
+            admitted[ myGraph.toRelabelled[ original ] ] = 1;
+        }
+    }
+    for( vertex_id_t const vertex : std::views::iota( 0, myGraph.size ) )
+    {
+        admitted[ vertex ] = admitted[ vertex ]
+                          && std::ranges::all_of( filter.ranges, [ &label = myGraph.labels[ vertex ] ]( LabelRange const& range )
+                             {
+                                 return range.lower <= label[ range.dimension ] && label[ range.dimension ] <= range.upper;
+                             } );
+    }
+    return admitted;
+}
+
+auto ParseLabelRange( std::string const& text ) -> LabelRange
+{
+    auto const first = text.find( ':' );
+    auto const second = first == std::string::npos ? std::string::npos : text.find( ':', first + 1 );
+    if( second == std::string::npos || text.find( ':', second + 1 ) != std::string::npos )
+    {
+        throw std::invalid_argument( "label range must be <dimension>:<lower>:<upper>: " + text );
+    }
+
+    auto const parse = [ &text ]( std::size_t const begin, std::size_t const end, coordinate_t const open ) -> coordinate_t
+    {
+        if( begin == end )
+        {
+            return open;
+        }
+        std::size_t parsed = 0;
+        int value = 0;
+        try
+        {
+            value = std::stoi( text.substr( begin, end - begin ), &parsed );
+        }
+        catch( std::logic_error const& ) // not a number, or out of range
+        {
+        }
+        if( parsed != end - begin )
+        {
+            throw std::invalid_argument( "malformed label range: " + text );
+        }
+        return value;
+    };
+
+    LabelRange range;
+    if( first == 0 )
+    {
+        throw std::invalid_argument( "label range needs a dimension: " + text );
+    }
+    range.dimension = parse( 0, first, 0 );
+    range.lower = parse( first + 1, second, range.lower );
+    range.upper = parse( second + 1, text.size(), range.upper );
+    return range;
+}
+
+auto ToOriginalIds( group_list_t groups, Graph const& myGraph ) -> group_list_t
+{
+    for( auto & group : groups )
+    {
+        std::transform( std::cbegin( group )
+                      , std::cend  ( group )
+                      , std::begin ( group )
+                      , [ &myGraph ]( vertex_id_t const vertex )
+                        {
+                            return myGraph.toOriginal[ vertex ];
+                        } );
+    }
+    return groups;
+}
+
+} // namespace base
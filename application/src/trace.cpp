@@ -0,0 +1,89 @@
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+#include "trace.hpp"
+
+namespace { // anonymous
+
+struct Registry
+{
+    std::mutex mutex;
+    std::vector< std::unique_ptr< std::vector< trace::Span > > > threads;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+};
+
+auto GetRegistry() -> Registry &
+{
+    static Registry registry;
+    return registry;
+}
+
+std::atomic< bool > enabled = false;
+
+auto Microseconds( std::chrono::steady_clock::duration duration ) -> double
+{
+    return std::chrono::duration< double, std::micro >( duration ).count();
+}
+
+} // namespace anonymous
+
+
+namespace trace
+{
+
+void SetEnabled( bool const is_enabled )
+{
+    enabled.store( is_enabled, std::memory_order_relaxed );
+}
+
+bool IsEnabled()
+{
+    return enabled.load( std::memory_order_relaxed );
+}
+
+auto RegisterThread() -> std::vector< Span > *
+{
+    auto & registry = GetRegistry();
+    std::lock_guard lock( registry.mutex );
+    return registry.threads.emplace_back( std::make_unique< std::vector< Span > >() ).get();
+}
+
+void Clear()
+{
+    auto & registry = GetRegistry();
+    std::lock_guard lock( registry.mutex );
+    for( auto & spans : registry.threads )
+    {
+        spans->clear();
+    }
+    registry.start = std::chrono::steady_clock::now();
+}
+
+void WriteChromeTrace( std::ostream & out )
+{
+    auto & registry = GetRegistry();
+    std::lock_guard lock( registry.mutex );
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for( std::size_t thread = 0; thread < registry.threads.size(); ++thread )
+    {
+        for( auto const& span : *registry.threads[ thread ] )
+        {
+            out << ( first ? "" : "," ) << "\n{\"name\":\"" << span.name << "\",\"ph\":\"X\",\"pid\":1"
+                << ",\"tid\":" << thread
+                << ",\"ts\":" << Microseconds( span.start - registry.start )
+                << ",\"dur\":" << Microseconds( span.end - span.start );
+            if( span.vertex >= 0 || span.size >= 0 )
+            {
+                out << ",\"args\":{\"vertex\":" << span.vertex << ",\"neighbourhood_size\":" << span.size << "}";
+            }
+            out << "}";
+            first = false;
+        }
+    }
+    out << "\n]}\n";
+}
+
+} // namespace trace
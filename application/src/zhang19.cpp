@@ -1,12 +1,15 @@
 #include <numeric>
 #include <algorithm>
 #include <cassert>
+#include <optional>
 #include <vector>
 
 
 #include "dominance-tests.hpp"
-#include "group-skyline-concepts.hpp"
+#include "group-store.hpp"
 #include "listing-danisch.hpp"
+#include "memory-accounting.hpp"
+#include "metrics.hpp"
 #include "postprocessing.hpp"
 
 #include "zhang19.hpp"
@@ -22,23 +25,36 @@ namespace base
     static_assert(std::is_same<SpatialPoint, myLabel>::value, "SpatialPoint type is consistent with structs.hpp");
     static_assert(std::is_same<PointList, myLabelVec>::value, "PointList type is consistent with structs.hpp");
 
-    CliqueList selectSkylineCliques(CliqueList && all_cliques, PointList const& labels)
+    /**
+     * Copies a list of cliques into a store of groups, computing their virtual points
+     */
+    GroupStore toGroupStore(CliqueList const& cliques, size_t cliqueSize, PointList const& labels)
     {
+        GroupStore store(cliqueSize, labels.empty() ? 0 : labels.front().size());
+        store.reserve(cliques.size());
+        for(auto const& clique : cliques)
+        {
+            store.Append(clique, labels);
+        }
+        return store;
+    }
+
+    /**
+     * Removes every clique that is dominated by another clique that has not been removed, preserving the order of the rest
+     */
+    GroupStore selectSkylineCliques(GroupStore && all_cliques, PointList const& labels)
+    {
+        std::vector<bool> isSkyline(all_cliques.size(), true);
         for(auto i = 0lu, n = all_cliques.size(); i < n; ++i)
         {
-            if(std::any_of(std::cbegin(all_cliques), std::cend(all_cliques),
-            [&labels, &clique = all_cliques[i]](auto const& comparePoint)
+            for(auto j = 0lu; j < n && isSkyline[i]; ++j)
             {
-                return GroupDominanceTest(comparePoint.cbegin(), comparePoint.cend(), clique.cbegin(), clique.cend(), labels);
-            }))
-            {
-                std::swap(all_cliques[i], all_cliques.back());
-                all_cliques.resize(--n);
-                --i;
+                isSkyline[i] = !(isSkyline[j] && GroupDominates(all_cliques, j, all_cliques, i, labels));
             }
         }
+        all_cliques.Compact(isSkyline);
 
-        return all_cliques;        
+        return std::move(all_cliques);
     }
 
     namespace zhang
@@ -46,47 +62,51 @@ namespace base
         /**
          * Algorithm 2 from Zhang et al. (2019). CIKM.
          * Conducts dominance check between two cliques with a series of pruning conditions.
-         * Returns true if s group-dominates c; false otherwise.
+         * Returns true if the s'th skyline clique group-dominates the c'th candidate; false otherwise.
          */
-        bool cliqueSDominatesCliqueC(Clique const& c, Clique const& s, PointList const& labels)
+        bool cliqueSDominatesCliqueC(GroupStore const& candidates, size_t c, GroupStore const& skyline, size_t s, PointList const& labels)
         {
-            myLabel const worst = GetWorstVirtualPoint(s, labels);
-            myLabel const best  = GetBestVirtualPoint(s, labels);
-            if(PointDominanceTest(worst.cbegin(), worst.cend(), best.cbegin()) == DominanceTestResult::dominates) { return true; }
+            auto const worst = skyline.Worst(s);
+            auto const best  = skyline.Best(s);
+            if(PointDominanceTest(worst.begin(), worst.end(), best.begin()) == DominanceTestResult::dominates) { return true; }
 
             // reduction to common elements performed inside GroupDominanceTest() function below.
             // Bipartite matching not relevant to this group-dominance definition (too expensive).
 
-            return GroupDominanceTest(s.cbegin(), s.cend(), c.cbegin(), c.cend(), labels);
+            return GroupDominates(skyline, s, candidates, c, labels);
         }
 
-        template <typename CliqueIterator>
-        bool cliqueRangeDominatesCliqueC(Clique const& c, CliqueIterator start, CliqueIterator end, PointList const& labels)
+        bool skylineDominatesCliqueC(GroupStore const& candidates, size_t c, GroupStore const& skyline, PointList const& labels)
         {
-            return std::any_of(start, end,
-                [&c, &labels](auto const& clique_s)
+            for(auto s = 0lu, n = skyline.size(); s < n; ++s)
+            {
+                if(cliqueSDominatesCliqueC(candidates, c, skyline, s, labels))
                 {
-                    return cliqueSDominatesCliqueC(c, clique_s, labels);
-                });
+                    return true;
+                }
+            }
+            return false;
         }
 
-        void copySkylineCliques(CliqueList& skylineCommunities, CliqueList && candidates, PointList const& labels)
+        void copySkylineCliques(GroupStore& skylineCommunities, GroupStore && candidates, PointList const& labels)
         {
             auto const skyline_cliques = selectSkylineCliques(std::move(candidates), labels);
-            std::copy(std::cbegin(skyline_cliques), std::cend(skyline_cliques), std::back_inserter(skylineCommunities));
+            for(auto i = 0lu, n = skyline_cliques.size(); i < n; ++i)
+            {
+                skylineCommunities.Append(skyline_cliques, i);
+            }
         }
 
-        CliqueList filterCliquesWithSkyline(CliqueList && cliques, CliqueList const& skylineCommunities, PointList const& labels)
+        GroupStore filterCliquesWithSkyline(GroupStore && cliques, GroupStore const& skylineCommunities, PointList const& labels)
         {
-            cliques.erase(
-                std::remove_if(cliques.begin(), cliques.end(),
-                    [start=std::cbegin(skylineCommunities), end=std::cend(skylineCommunities), &labels](auto const& clique)
-                    {
-                        return cliqueRangeDominatesCliqueC(clique, start, end, labels);
-                    })
-                , cliques.end());
+            std::vector<bool> isUndominated(cliques.size());
+            for(auto c = 0lu, n = cliques.size(); c < n; ++c)
+            {
+                isUndominated[c] = !skylineDominatesCliqueC(cliques, c, skylineCommunities, labels);
+            }
+            cliques.Compact(isUndominated);
 
-            return cliques;
+            return std::move(cliques);
         }
 
         auto fetchLayerBoundaries(Layer l, std::vector<Layer> const& boundaries)
@@ -118,35 +138,63 @@ namespace base
         }
 
 
-        void extractSkylineCommunitiesFromLayer(CliqueList& skylineCommunities, Layer layer, Graph const& graph, size_t cliqueSize)
+        /**
+         * Adds the skyline cliques whose first member is in the given layer; returns the vertex
+         * at which the query ran out of budget, if it did
+         */
+        std::optional<Node> extractSkylineCommunitiesFromLayer(GroupStore& skylineCommunities, Layer layer, Graph const& graph, size_t cliqueSize, QueryContext const& context)
         {
             auto const adjMap = adjListToMap(graph.edges);
             auto const [layer_start, layer_end] = fetchLayerBoundaries(layer, graph.skyLayersBoundaries);
 
-            for(auto cur_node = layer_start; cur_node < layer_end; ++cur_node)
+            for(auto cur_node = layer_start; cur_node < layer_end && !context.IsCancelled(); ++cur_node)
             {
+                if(context.IsOverBudget(cur_node))
+                {
+                    return cur_node;
+                }
                 auto const tailset = filterTailsetToAdjacent(graph.edges[cur_node], cur_node);
                 if(!graphIsSkippable(tailset, cliqueSize - 1))
                 {
-                    auto const subgraph = listing::induceSubgraph(adjMap, NodeSet(tailset.cbegin(), tailset.cend()));
+                    auto const subgraph = [&]
+                    {
+                        metrics::ScopedPhase phase(metrics::Phase::neighbourhood);
+                        return listing::induceSubgraph(adjMap, NodeSet(tailset.cbegin(), tailset.cend()));
+                    }();
                     if(!graphIsSkippable(subgraph, cliqueSize - 1))
                     {
-                        auto cliquesWithThisNode = listing::getCliquesContainingNode(subgraph, cur_node, cliqueSize);
+                        auto cliquesWithThisNode = [&]
+                        {
+                            metrics::ScopedPhase phase(metrics::Phase::listing);
+                            return toGroupStore(listing::getCliquesContainingNode(subgraph, cur_node, cliqueSize), cliqueSize, graph.labels);
+                        }();
+                        metrics::Add(metrics::Counter::candidates_listed, cliquesWithThisNode.size());
+                        memory::ScopedBytes const candidateBytes(memory::Subsystem::candidates, memory::BytesOf(cliquesWithThisNode));
+
+                        metrics::ScopedPhase phase(metrics::Phase::dominance_filtering);
                         auto filteredCliques = filterCliquesWithSkyline(std::move(cliquesWithThisNode), skylineCommunities, graph.labels);
                         copySkylineCliques(skylineCommunities, std::move(filteredCliques), graph.labels);
                     }
                 }
             } 
+            return std::nullopt;
         }
 
-        void updateRepresentatives(PointList & representatives, CliqueList const& cliques, PointList const& labels)
+        /**
+         * Streams the groups from position emitted onwards that are final to the context's sink, if any
+         */
+        size_t emitFinalGroups(GroupStore const& skylineCommunities, size_t emitted, PointList const& labels, QueryContext const& context, bool isComplete)
         {
-            // Assumes that all cliques that are not yet in the representative list come at the end of the clique list.
-            std::transform(std::cbegin(cliques) + representatives.size(), std::cend(cliques), std::back_inserter(representatives),
-                [&labels](auto const& clique)
+            if(context.sink == nullptr)
+            {
+                return emitted;
+            }
+            auto const resume = EmitFinalGroups(skylineCommunities.cbegin() + emitted, skylineCommunities.cend(), labels,
+                [&context](auto const& clique)
                 {
-                    return GetWorstVirtualPoint(clique, labels);
-                });
+                    context.sink->Write(clique);
+                }, isComplete);
+            return resume - skylineCommunities.cbegin();
         }
 
 
@@ -155,16 +203,21 @@ namespace base
          * Modified to exclude contributions relating to permutation-based dominance definition
          * Performs layer-based iteration strategy with early pruning by layer and node pruning by coreness
          */
-        void GetSkylineCommunities(Graph& myGraph, [[maybe_unused]] int coreSize, int groupSize, CliqueList& skylineCommunities)
+        void GetSkylineCommunities(Graph const& myGraph, [[maybe_unused]] int coreSize, int groupSize, CliqueList& skylineCommunities, QueryContext const& context)
         {
             assert("Zhang19 can only handle cliques" && (coreSize == groupSize - 1));
             skylineCommunities.clear();
-            PointList skylineRepresentatives;
+            GroupStore skyline(groupSize, myGraph.labels.empty() ? 0 : myGraph.labels.front().size()); // with the worst virtual point of each clique for termination
+            size_t emitted = 0; // number of skyline groups passed to the context's sink
+            std::optional<Node> frontier; // the vertex at which the query ran out of budget, if it did
 
-            for(auto layer = 0lu, n = myGraph.skyLayersBoundaries.size(); layer < n; ++layer)
+            for(auto layer = 0lu, n = myGraph.layerRepresentatives.size(); layer < n && !context.IsCancelled(); ++layer)
             {
-                if(CanTerminate(skylineRepresentatives, myGraph.layerRepresentatives[layer]))
+                metrics::RecordSkylineSize(context.record, myGraph.skyLayersBoundaries[layer], skyline.size());
+                if(CanTerminate(skyline, myGraph.layerRepresentatives[layer]))
                 {
+                    metrics::Add(metrics::Counter::vertices_skipped_by_termination, myGraph.size - myGraph.skyLayersBoundaries[layer]);
+                    metrics::RecordTermination(context.record, layer);
                     // Early Termination 2: Best of layer is dominated by a point in the skyline
                     // Note: comments on implementation of Theorem 5 state that, following [BKS01],
                     // max points of each skyline clique should be indexed in an R-tree.
@@ -180,16 +233,33 @@ namespace base
                 }
                 else
                 {
-                    extractSkylineCommunitiesFromLayer(skylineCommunities, layer, myGraph, static_cast<size_t>(groupSize));
-                    updateRepresentatives(skylineRepresentatives, skylineCommunities, myGraph.labels);
+                    frontier = extractSkylineCommunitiesFromLayer(skyline, layer, myGraph, static_cast<size_t>(groupSize), context);
+                    if(frontier)
+                    {
+                        break;
+                    }
+                    emitted = emitFinalGroups(skyline, emitted, myGraph.labels, context, false);
                 }
             }
 
-            // similar to remove-erase idiom; get rid of false positives
-            skylineCommunities.erase( postprocess( std::begin( skylineCommunities )
-                                                 , std::end( skylineCommunities )
-                                                 , myGraph.labels )
-                                    , std::end( skylineCommunities ) );
+            if(!frontier)
+            {
+                emitFinalGroups(skyline, emitted, myGraph.labels, context, true);
+            }
+
+            memory::ScopedBytes const skylineBytes(memory::Subsystem::skyline, memory::BytesOf(skyline));
+
+            // get rid of false positives, and of groups that the rest of the scan could have shown to be
+            metrics::ScopedPhase phase(metrics::Phase::postprocess);
+            if(frontier)
+            {
+                FinishPartialSkyline(skyline, emitted, myGraph.labels, *frontier, context);
+            }
+            else
+            {
+                postprocess(skyline, myGraph.labels);
+            }
+            skylineCommunities = skyline.ToGroupList();
         }      
     } // namespace zhang
 
@@ -202,13 +272,13 @@ namespace base
          * Algorithm 1 in Zhang et al. (CIKM 2019). "Selecting the Optimal Groups: Efficiently Computing Skyline k-Cliques"
          * Simple baseline that retrieves all cliques and then runs a stupidly naive nested loop algorithm over them.
          */
-        void GetSkylineCommunities(Graph& myGraph, [[maybe_unused]] int coreSize, int groupSize, CliqueList& skylineCommunities)
+        void GetSkylineCommunities(Graph const& myGraph, [[maybe_unused]] int coreSize, int groupSize, CliqueList& skylineCommunities)
         {
             assert("Baselines can only handle cliques" && (coreSize == groupSize - 1));
             skylineCommunities.clear();
 
-            auto all_cliques = listing::getAllCliques(myGraph.edges, groupSize);
-            skylineCommunities = selectSkylineCliques(std::move(all_cliques), myGraph.labels);
+            auto all_cliques = toGroupStore(listing::getAllCliques(myGraph.edges, groupSize), groupSize, myGraph.labels);
+            skylineCommunities = selectSkylineCliques(std::move(all_cliques), myGraph.labels).ToGroupList();
         }
     } // namespace zhangBaseline
 } // namespace base